@@ -0,0 +1,127 @@
+/// \file   AcmeJournalTool.cpp
+/// \brief  Offline analysis of MineJournal files: rebuilds the CSV statistics and answers queries
+#include "AcmeMinerUtils.h"
+#include "MineJournal.h"
+#include "MineStatsSink.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <string>
+
+using namespace acme;
+
+namespace {
+///
+const char* usageMessage() {
+    return "Usage: acme-journal <journal-file> [--csv[=<timestamp>]] [--truck=<id>] "
+           "[--station=<id>]";
+}
+
+/// Prints the journal header and the number of records of each kind
+void printSummary(const MineJournalReader& reader) {
+    const auto& header = reader.getHeader();
+    std::cout << header.numTrucks << " trucks, " << header.numStations << " stations, "
+              << header.numSites << " sites, " << header.ticksPerDay << " ticks, seed "
+              << header.seed << '\n';
+
+    std::array<std::size_t, NUM_TRUCK_STATES> truckEntries{};
+    std::array<std::size_t, NUM_STATION_STATES> stationEntries{};
+    std::size_t siteDispatches = 0;
+    std::size_t stationDispatches = 0;
+    std::size_t placesInQueue = 0;
+    reader.forEach([&](SimTime, const JournalRecord& record) {
+        switch (record.kind) {
+        case JournalKind::TRUCK_STATE:
+            ++truckEntries.at(record.value);
+            break;
+        case JournalKind::STATION_STATE:
+            ++stationEntries.at(record.value);
+            break;
+        case JournalKind::SITE_DISPATCH:
+            ++siteDispatches;
+            break;
+        case JournalKind::STATION_DISPATCH:
+            ++stationDispatches;
+            placesInQueue += record.value;
+            break;
+        }
+    });
+
+    std::cout << reader.getNumRecords() << " records of " << sizeof(JournalRecord) << " bytes\n";
+    for (std::size_t state = 0; state < truckEntries.size(); ++state) {
+        std::cout << "  Truck   entered " << TRUCK_STATE_NAME[state] << ": " << truckEntries[state]
+                  << '\n';
+    }
+    for (std::size_t state = 0; state < stationEntries.size(); ++state) {
+        std::cout << "  Station entered " << STATION_STATE_NAME[state] << ": "
+                  << stationEntries[state] << '\n';
+    }
+    std::cout << "  Site dispatches: " << siteDispatches << '\n';
+    std::cout << "  Station dispatches: " << stationDispatches;
+    if (stationDispatches != 0) {
+        std::cout << ", mean place in queue "
+                  << static_cast<double>(placesInQueue) / stationDispatches;
+    }
+    std::cout << '\n';
+}
+
+/// Prints every record about one truck, or one station
+void printTimeline(const MineJournalReader& reader, bool truck, std::uint32_t id) {
+    reader.forEach([&](SimTime tick, const JournalRecord& record) {
+        if (record.entity != id) {
+            return;
+        }
+
+        auto timestamp = tickToTimestamp(std::max(tick, 0));
+        if (truck && record.kind == JournalKind::TRUCK_STATE) {
+            std::cout << timestamp << " : " << TRUCK_STATE_NAME.at(record.value) << '\n';
+        } else if (truck && record.kind == JournalKind::SITE_DISPATCH) {
+            std::cout << timestamp << " : dispatched to " << genMinionName("ASIT", record.target)
+                      << '\n';
+        } else if (truck && record.kind == JournalKind::STATION_DISPATCH) {
+            std::cout << timestamp << " : dispatched to " << genMinionName("ASTN", record.target)
+                      << ", place " << static_cast<int>(record.value) << " in queue\n";
+        } else if (!truck && record.kind == JournalKind::STATION_STATE) {
+            std::cout << timestamp << " : " << STATION_STATE_NAME.at(record.value) << '\n';
+        }
+    });
+}
+}  // namespace
+
+///
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << usageMessage() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    try {
+        auto reader = MineJournalReader(argv[1]);
+        if (argc == 2) {
+            printSummary(reader);
+        }
+
+        for (auto arg = 2; arg < argc; ++arg) {
+            std::string option(argv[arg]);
+            if (option == "--csv" || option.rfind("--csv=", 0) == 0) {
+                auto timestamp = option.size() > 6 ? option.substr(6) : createISODateStamp();
+                auto stats = MineCsvStatsSink(timestamp);
+                MineJournalReplay(reader).outputStatistics(stats);
+            } else if (option.rfind("--truck=", 0) == 0) {
+                printTimeline(reader, true, std::stoul(option.substr(8)));
+            } else if (option.rfind("--station=", 0) == 0) {
+                printTimeline(reader, false, std::stoul(option.substr(10)));
+            } else {
+                std::cerr << usageMessage() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    } catch (const std::exception& exception) {
+        std::cerr << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+/// \file   AcmeMinerBench.cpp
+/// \brief  Micro-benchmarks of the simulator's hot paths
+#include "AcmeMinerUtils.h"
+#include "MineAllocCounter.h"
+#include "MineDispatchers.h"
+#include "MineLogger.h"
+#include "MineOverlord.h"
+#include "MineSite.h"
+#include "MineStation.h"
+#include "MineStatsSink.h"
+#include "MineTruck.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+using namespace acme;
+
+namespace {
+/// Every truck with its own site, and the stations they share
+struct BenchMine {
+    MineOverlord overlord;
+    MinePool<MineTruck> trucks;
+    MinePool<MineStation> stations;
+    MinePool<MineSite> sites;
+};
+
+/// Sets up a fresh mine, with every truck at its site
+BenchMine setUpMine(int numTrucks, int numStations) {
+    MineRegistry::getInstance().reset();
+    auto overlord = MineOverlord();
+    auto trucks = instantiateTrucks(overlord, numTrucks);
+    auto stations = instantiateStations(overlord, numStations);
+    auto sites = instantiateSites(overlord, numTrucks, 0);
+    startTrucksAtMines();
+    return {std::move(overlord), std::move(trucks), std::move(stations), std::move(sites)};
+}
+
+/// One station per ten trucks, as in a busy mine
+int stationsFor(int numTrucks) {
+    return std::max(1, numTrucks / 10);
+}
+
+/// Updating every truck, station and site for one tick, and the heap allocations that takes
+void BM_OverlordNotify(benchmark::State& state) {
+    auto numTrucks = static_cast<int>(state.range(0));
+    auto numStations = stationsFor(numTrucks);
+    auto mine = setUpMine(numTrucks, numStations);
+
+    auto& allocCounter = MineAllocCounter::getInstance();
+    allocCounter.reset();
+    allocCounter.start();
+    auto tick = 0;
+    for (auto _ : state) {
+        mine.overlord.notify(tick++);
+    }
+    allocCounter.stop();
+    state.SetItemsProcessed(state.iterations() * (2 * numTrucks + numStations));
+    state.counters["allocsPerTick"] = benchmark::Counter(
+        static_cast<double>(allocCounter.getCount()), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_OverlordNotify)
+    ->RangeMultiplier(10)
+    ->Range(100, 100000)
+    ->Unit(benchmark::kMicrosecond);
+
+/// A truck joining the shortest of M station queues, while another leaves its queue
+void BM_StationDispatcher(benchmark::State& state) {
+    auto numStations = static_cast<int>(state.range(0));
+    auto mine = setUpMine(1, numStations);
+    auto stationDispatcher = MineRegistry::getInstance().getStationDispatcher();
+
+    auto leaving = 0;
+    for (auto _ : state) {
+        auto* station = stationDispatcher->getNextAvailableStation();
+        station->enqueue(&mine.trucks[0]);
+        stationDispatcher->enqueue(station);
+
+        auto& other = mine.stations[leaving++ % numStations];
+        if (other.getQueueSize() != 0) {
+            other.dequeue();
+            stationDispatcher->enqueue(&other);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StationDispatcher)->RangeMultiplier(10)->Range(10, 100000);
+
+/// A site being taken from, and returned to, the queue of N available sites
+void BM_SiteDispatcher(benchmark::State& state) {
+    auto mine = setUpMine(0, 1);
+    auto sites = MinePool<MineSite>(state.range(0));
+    auto siteDispatcher = MineRegistry::getInstance().getSiteDispatcher();
+    for (auto site = 0; site < static_cast<int>(sites.capacity()); ++site) {
+        siteDispatcher->enqueue(sites.emplace(genMinionName("ASIT", site), site));
+    }
+
+    for (auto _ : state) {
+        siteDispatcher->enqueue(siteDispatcher->getNextAvailableMine());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SiteDispatcher)->RangeMultiplier(10)->Range(100, 100000);
+
+/// A truck going through every state once, with the dispatching each state entails
+void BM_TruckStateTransitions(benchmark::State& state) {
+    auto mine = setUpMine(1, 1);
+    auto& truck = mine.trucks[0];
+    auto& station = mine.stations[0];
+    auto siteDispatcher = MineRegistry::getInstance().getSiteDispatcher();
+
+    for (auto _ : state) {
+        truck.setTruckState(TruckState::INBOUND);
+        truck.setTruckState(TruckState::QUEUED);
+        station.dequeue();
+        truck.setTruckState(TruckState::UNLOADING);
+        siteDispatcher->enqueue(truck.getAssignedMineSite());
+        truck.setTruckState(TruckState::OUTBOUND);
+        truck.setTruckState(TruckState::MINING);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_TRUCK_STATES);
+}
+BENCHMARK(BM_TruckStateTransitions);
+
+/// Handing a message to the writer thread; a fixed number of them keeps the log file small
+void BM_LoggerLogMessage(benchmark::State& state) {
+    auto& logger = MineLogger::getInstance();
+    const std::string message =
+        "00:00:00 : Truck   ATRK-000000 MINING    at ASIT-000000, remaining duration 60 minutes";
+    for (auto _ : state) {
+        logger.logMessage(message);
+    }
+    logger.flush();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerLogMessage)->Iterations(1 << 17);
+
+/// A message whose level is turned off, as most per-tick messages are in large runs
+void BM_LoggerFilteredMessage(benchmark::State& state) {
+    auto truck = 0;
+    for (auto _ : state) {
+        ACME_LOG(INFO, TRUCK, truck, "Truck " << truck << " filtered out");
+        ++truck;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LoggerFilteredMessage);
+
+///
+void BM_TickToTimestamp(benchmark::State& state) {
+    auto tick = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(tickToTimestamp(tick));
+        tick = (tick + 1) % TICKS_PER_DAY;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TickToTimestamp);
+
+///
+void BM_GenMinionName(benchmark::State& state) {
+    auto serial = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(genMinionName("ATRK", serial++));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GenMinionName);
+
+/// Handing the statistics of a whole simulation day to a sink
+void BM_OutputStatistics(benchmark::State& state) {
+    auto numTrucks = static_cast<int>(state.range(0));
+    auto mine = setUpMine(numTrucks, stationsFor(numTrucks));
+    for (auto tick = 0; tick < TICKS_PER_DAY; ++tick) {
+        mine.overlord.notify(tick);
+    }
+
+    std::size_t numRows = 0;
+    for (auto _ : state) {
+        auto stats = MineNullStatsSink();
+        mine.overlord.outputStatistics(stats);
+        numRows = stats.getNumRows();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(numRows));
+}
+BENCHMARK(BM_OutputStatistics)
+    ->RangeMultiplier(10)
+    ->Range(100, 10000)
+    ->Unit(benchmark::kMicrosecond);
+}  // namespace
+
+/// Runs the benchmarks with the simulation's own messages turned off; pass
+/// --benchmark_out=FILE --benchmark_out_format=json for machine-readable results
+int main(int argc, char** argv) {
+    auto& logger = MineLogger::getInstance();
+    logger.setConsole(false);
+    for (std::size_t category = 0; category < NUM_LOG_CATEGORIES; ++category) {
+        logger.setLevel(static_cast<LogCategory>(category), LogLevel::OFF);
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
\ No newline at end of file
@@ -1,44 +1,245 @@
 /// \file   AcmeMinerSim.cpp
 #include "AcmeMinerUtils.h"
+#include "MineBranches.h"
+#include "MineDispatchers.h"
+#include "MineJournal.h"
+#include "MineLogger.h"
+#include "MineMetrics.h"
+#include "MineOptions.h"
 #include "MineOverlord.h"
+#include "MinePacer.h"
+#include "MineReplications.h"
+#include "MineSetupMeter.h"
+#include "MineSite.h"
+#include "MineStation.h"
+#include "MineStatsSink.h"
+#include "MineSweep.h"
+#include "MineTrace.h"
+#include "MineTruck.h"
+#include "MineWorkerPool.h"
+#include "TruckFleet.h"
 
-#include <cassert>
+#include <cstdlib>
 #include <iostream>
-#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
 
 using namespace acme;
 
+namespace {
+/// Creates the destination of the end-of-day statistics, named after the date stamp
+std::unique_ptr<MineStatsSink> createStatsSink(
+    const MineOptions& options,
+    const std::string& dateStamp) {
+    if (!options.statistics) {
+        return std::make_unique<MineNullStatsSink>();
+    }
+    return std::make_unique<MineCsvStatsSink>(dateStamp);
+}
+
+/// Logs the metrics of the run, and writes them next to the statistics files, if there are any;
+/// writes the trace, if it is recorded
+void reportMetrics(const MineOptions& options, const std::string& dateStamp) {
+    MineLogger::getInstance().flush();
+    auto& metrics = MineMetrics::getInstance();
+    metrics.stopHardwareCounters();
+    metrics.report();
+    if (options.statistics) {
+        metrics.writeJson(dateStamp + "_MineMetrics.json");
+    }
+    if (options.trace) {
+        MineTrace::getInstance().writeJson(dateStamp + "_MineTrace.json");
+    }
+}
+}  // namespace
+
 ///
 int main(int argc, char** argv) {
-    // Usage note if incorrect number of arguments
-    if (argc != 3) {
-        std::cerr << "Usage: acme-mining <number-of-trucks> <number-of-stations>" << std::endl;
-        EXIT_FAILURE;
+    // Usage note if the command line is malformed
+    MineOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << usageMessage() << std::endl;
+        return EXIT_FAILURE;
     }
 
-    // Process input
-    auto numTrucks = std::stoi(*++argv);
-    assert(numTrucks > 0 && numTrucks < std::numeric_limits<int>::max());
+    // Hardware counters, where the kernel allows them, count every thread started from here on,
+    // and the trace names every thread started from here on
+    MineMetrics::getInstance().startHardwareCounters();
+    if (options.trace) {
+        MineTrace::getInstance().enable();
+        MineTrace::getInstance().setThreadName("simulation");
+    }
+    auto& logger = MineLogger::getInstance();
+    logger.setFullPolicy(options.logFullPolicy);
+    for (std::size_t category = 0; category < NUM_LOG_CATEGORIES; ++category) {
+        logger.setLevel(static_cast<LogCategory>(category), options.logLevels[category]);
+    }
+    logger.setSampleRate(options.logSampleRate);
 
-    auto numStations = std::stoi(*++argv);
-    assert(numStations > 0 && numStations < std::numeric_limits<int>::max());
+    // A sweep runs a whole simulation day per grid point, as many at a time as there are workers
+    if (options.sweep) {
+        auto sweep = MineSweep(options.sweepGrid, options.seed);
+        std::cout << "Sweeping " << sweep.getPoints().size() << " combinations of trucks, "
+                  << "stations, sites and durations." << std::endl;
 
-    auto numSites = numTrucks;
+        auto workerPool = MineWorkerPool(options.numThreads);
+        logSimulationHeader(options.numTrucks, options.numStations, options.seed);
+        sweep.run(workerPool);
+
+        auto outputTimer = MinePhaseTimer(MetricPhase::STATS_OUTPUT);
+        auto dateStamp = createISODateStamp();
+        sweep.outputSummary(dateStamp);
+        outputTimer.stop();
+        reportMetrics(options, dateStamp);
+        return EXIT_SUCCESS;
+    }
+
+    auto numTrucks = options.numTrucks;
+    auto numStations = options.numStations;
+    auto numSites = options.numSites != 0 ? options.numSites : numTrucks;
     std::cout << "Setting up simulation with " << numTrucks << " trucks, " << numSites
               << " mining sites, and " << numStations << " stations." << std::endl;
 
-    // Instantiate simulation objects
+    // A Monte Carlo batch runs whole simulation days side by side, one per worker
+    if (options.numReplications > 1) {
+        auto replications =
+            MineReplications(numTrucks, numStations, options.numReplications, options.seed);
+
+        auto workerPool = MineWorkerPool(options.numThreads);
+        logSimulationHeader(numTrucks, numStations, options.seed);
+        replications.run(workerPool);
+
+        auto outputTimer = MinePhaseTimer(MetricPhase::STATS_OUTPUT);
+        auto dateStamp = createISODateStamp();
+        replications.outputSummary(dateStamp);
+        outputTimer.stop();
+        reportMetrics(options, dateStamp);
+        return EXIT_SUCCESS;
+    }
+
+    // Every transition and dispatch decision can also be recorded in a binary journal
+    std::unique_ptr<MineJournal> journal;
+    if (options.journal) {
+        try {
+            journal = std::make_unique<MineJournal>(
+                createISODateStamp() + "_MineJournal.bin",
+                numTrucks,
+                numStations,
+                numSites,
+                options.seed);
+        } catch (const std::runtime_error& exception) {
+            std::cerr << exception.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Setup is timed, and its heap usage measured, one kind of entity at a time
+    auto setupTimer = MinePhaseTimer(MetricPhase::SETUP);
+    auto setupMeter = MineSetupMeter();
+
+    // The structure-of-arrays fleet replaces the simulation objects altogether
+    if (options.engine == SimEngine::FLEET) {
+        auto fleet =
+            TruckFleet(numTrucks, numStations, numSites, options.seed, options.durations);
+        setupMeter.report("fleet trucks, with their stations and sites", numTrucks);
+        fleet.setJournal(journal.get());
+        auto workerPool = MineWorkerPool(options.numThreads);
+        if (workerPool.size() > 1) {
+            fleet.setWorkerPool(&workerPool);
+        }
+        try {
+            // A resumed day carries on from its checkpoint, with the seed it was started with
+            if (options.resumeFrom.empty()) {
+                fleet.startTrucksAtMines();
+            } else {
+                fleet.readCheckpoint(options.resumeFrom);
+            }
+            setupTimer.stop();
+
+            logSimulationHeader(numTrucks, numStations, fleet.getSeed());
+            auto firstTick = fleet.getNextTick();
+            auto pacer = MinePacer(options.realTimeFactor, firstTick);
+
+            // What-if branches share the day up to the branch tick, then each runs the rest of it
+            if (options.branchTick >= 0) {
+                if (options.branchTick < firstTick) {
+                    throw std::runtime_error("Cannot branch before the tick the day resumes at");
+                }
+                fleet.run(pacer, options.branchTick);
+                auto branches = MineBranches(options.whatIfs);
+                pacer.report(options.branchTick - firstTick);
+                branches.run(fleet, pacer);
+
+                auto dateStamp = createISODateStamp();
+                branches.outputReport(dateStamp);
+                reportMetrics(options, dateStamp);
+                return EXIT_SUCCESS;
+            }
+
+            if (options.checkpointTick >= 0) {
+                if (options.checkpointTick < firstTick) {
+                    throw std::runtime_error(
+                        "Cannot checkpoint before the tick the day resumes at");
+                }
+                fleet.run(pacer, options.checkpointTick);
+                auto fileName = createISODateStamp() + "_MineCheckpoint.bin";
+                fleet.writeCheckpoint(fileName);
+                logger.logMessage(
+                    "Checkpoint before tick " + std::to_string(options.checkpointTick)
+                    + " written to " + fileName);
+            }
+            fleet.run(pacer);
+            pacer.report(TICKS_PER_DAY - firstTick);
+            if (journal) {
+                journal->close();
+            }
+        } catch (const std::runtime_error& exception) {
+            std::cerr << exception.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        auto outputTimer = MinePhaseTimer(MetricPhase::STATS_OUTPUT);
+        auto dateStamp = createISODateStamp();
+        auto stats = createStatsSink(options, dateStamp);
+        fleet.outputStatistics(*stats);
+        stats->close();
+        outputTimer.stop();
+        reportMetrics(options, dateStamp);
+        return EXIT_SUCCESS;
+    }
+
+    // Instantiate simulation objects, each kind side by side in one allocation; they are torn
+    // down when main returns
     auto overlord = MineOverlord();
-    instantiateTrucks(overlord, numTrucks);
-    instantiateStations(overlord, numStations);
-    instantiateSites(overlord, numSites);
+    auto trucks = instantiateTrucks(overlord, numTrucks);
+    setupMeter.report("trucks", numTrucks);
+    auto stations = instantiateStations(overlord, numStations);
+    setupMeter.report("stations", numStations);
+    auto sites = instantiateSites(overlord, numSites, options.seed);
+    setupMeter.report("sites", numSites);
 
     // All trucks are at mines initially
+    MineRegistry::getInstance().setJournal(journal.get());
     startTrucksAtMines();
+    setupTimer.stop();
 
     // Run one simulation day, then output statistics
-    overlord.run(numTrucks, numStations);
-    overlord.outputStatistics();
-    EXIT_SUCCESS;
+    try {
+        overlord.run(options);
+        if (journal) {
+            journal->close();
+        }
+    } catch (const std::runtime_error& exception) {
+        std::cerr << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    auto outputTimer = MinePhaseTimer(MetricPhase::STATS_OUTPUT);
+    auto dateStamp = createISODateStamp();
+    auto stats = createStatsSink(options, dateStamp);
+    overlord.outputStatistics(*stats);
+    stats->close();
+    outputTimer.stop();
+    reportMetrics(options, dateStamp);
+    return EXIT_SUCCESS;
 }
\ No newline at end of file
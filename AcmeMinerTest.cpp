@@ -1,15 +1,46 @@
 /// \file   AcmeMinerTest.cpp
 /// \brief  Unit tests for various Mine constructs
 #include "AcmeMinerUtils.h"
+#include "MineAllocCounter.h"
+#include "MineBranches.h"
+#include "MineCheckpoint.h"
 #include "MineDispatchers.h"
+#include "MineEventEngine.h"
+#include "MineIndexedHeap.h"
+#include "MineJournal.h"
+#include "MineLogRing.h"
+#include "MineLogger.h"
+#include "MineMetrics.h"
+#include "MineOverlord.h"
+#include "MinePacer.h"
+#include "MinePool.h"
+#include "MineReplications.h"
+#include "MineRingQueue.h"
 #include "MineSite.h"
+#include "MineStatsSink.h"
+#include "MineSweep.h"
 #include "MineTimer.h"
+#include "MineTimingWheel.h"
+#include "MineTrace.h"
 #include "MineTruck.h"
+#include "MineWorkerPool.h"
+#include "TruckFleet.h"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace acme;
 
@@ -17,6 +48,8 @@ using namespace acme;
 struct AcmeMinerTest : public ::testing::Test {
     ///
     void SetUp() override {
+        MineRegistry::getInstance().reset();
+
         myMineTimer = new MineTimer(H3_MINING_MIN, H3_MINING_MAX);
 
         myMineTruckA = new MineTruck("ATRK-00000A");
@@ -59,10 +92,135 @@ struct AcmeMinerTest : public ::testing::Test {
     MineSite* myMineSiteA{nullptr};
     MineSite* myMineSiteB{nullptr};
     MineSite* myMineSiteC{nullptr};
+
+    static constexpr int DAY_TRUCKS = 8;
+    static constexpr int DAY_STATIONS = 2;
+
+    /// Runs a small, unthrottled simulation day and checks that every tick is accounted for
+    /// \param notifyEveryTick   update every MineMinion on every tick, as the reference for the
+    ///                          engines, instead of running the day with the engine
+    /// \return every truck, station and site time, in that order
+    static std::vector<int> runMiningDay(
+        SimEngine engine,
+        std::uint64_t seed = 0,
+        bool notifyEveryTick = false) {
+        MineOptions options;
+        options.numTrucks = DAY_TRUCKS;
+        options.numStations = DAY_STATIONS;
+        options.engine = engine;
+        options.realTimeFactor = 0;
+        options.seed = seed;
+
+        auto overlord = MineOverlord();
+        std::vector<std::unique_ptr<MineTruck>> trucks;
+        std::vector<std::unique_ptr<MineStation>> stations;
+        std::vector<std::unique_ptr<MineSite>> sites;
+
+        auto truckDispatcher = MineRegistry::getInstance().getTruckDispatcher();
+        for (auto truck = 0; truck < options.numTrucks; ++truck) {
+            trucks.push_back(std::make_unique<MineTruck>(genMinionName("ATRK", truck), truck));
+            overlord.attach(trucks.back().get());
+            truckDispatcher->truckGarage.push_back(trucks.back().get());
+        }
+
+        auto stationDispatcher = MineRegistry::getInstance().getStationDispatcher();
+        for (auto station = 0; station < options.numStations; ++station) {
+            stations.push_back(
+                std::make_unique<MineStation>(genMinionName("ASTN", station), station));
+            overlord.attach(stations.back().get());
+            stationDispatcher->enqueue(stations.back().get());
+        }
+
+        auto siteDispatcher = MineRegistry::getInstance().getSiteDispatcher();
+        for (auto site = 0; site < options.numTrucks; ++site) {
+            sites.push_back(std::make_unique<MineSite>(genMinionName("ASIT", site), site, seed));
+            overlord.attach(sites.back().get());
+            siteDispatcher->enqueue(sites.back().get());
+        }
+
+        startTrucksAtMines();
+        if (notifyEveryTick) {
+            for (SimTime tick = 0; tick < TICKS_PER_DAY; ++tick) {
+                overlord.notify(tick);
+            }
+        } else {
+            overlord.run(options);
+        }
+
+        for (const auto& truck : trucks) {
+            auto ticks = truck->getTimeInState(TruckState::MINING)
+                         + truck->getTimeInState(TruckState::INBOUND)
+                         + truck->getTimeInState(TruckState::QUEUED)
+                         + truck->getTimeInState(TruckState::UNLOADING)
+                         + truck->getTimeInState(TruckState::OUTBOUND);
+            EXPECT_EQ(ticks, TICKS_PER_DAY);
+            EXPECT_GT(truck->getTimeInState(TruckState::UNLOADING), 0);
+        }
+
+        for (const auto& station : stations) {
+            auto ticks = station->getTimeInState(StationState::IDLE)
+                         + station->getTimeInState(StationState::READY)
+                         + station->getTimeInState(StationState::UNLOADING);
+            EXPECT_EQ(ticks, TICKS_PER_DAY);
+        }
+
+        for (const auto& site : sites) {
+            EXPECT_EQ(site->getIdleCount() + site->getMiningCount(), TICKS_PER_DAY);
+        }
+
+        std::vector<int> times;
+        for (const auto& truck : trucks) {
+            for (auto state = 0; state < 5; ++state) {
+                times.push_back(truck->getTimeInState(static_cast<TruckState>(state)));
+            }
+        }
+        for (const auto& station : stations) {
+            for (auto state = 0; state < 3; ++state) {
+                times.push_back(station->getTimeInState(static_cast<StationState>(state)));
+            }
+        }
+        for (const auto& site : sites) {
+            times.push_back(site->getIdleCount());
+            times.push_back(site->getMiningCount());
+        }
+        return times;
+    }
+
+    /// Runs the same simulation day as runMiningDay on a TruckFleet
+    /// \return every truck, station and site time, in that order
+    static std::vector<int> runFleetDay(std::uint64_t seed, int numWorkers) {
+        auto workerPool = MineWorkerPool(numWorkers);
+        auto fleet = TruckFleet(DAY_TRUCKS, DAY_STATIONS, DAY_TRUCKS, seed);
+        fleet.setWorkerPool(&workerPool);
+        fleet.startTrucksAtMines();
+        auto pacer = MinePacer(0);
+        fleet.run(pacer);
+        return getFleetTimes(fleet);
+    }
+
+    /// \return every truck, station and site time of a TruckFleet day, in that order
+    static std::vector<int> getFleetTimes(const TruckFleet& fleet) {
+        std::vector<int> times;
+        for (auto truck = 0; truck < DAY_TRUCKS; ++truck) {
+            for (auto state = 0; state < 5; ++state) {
+                times.push_back(fleet.getTimeInState(truck, static_cast<TruckState>(state)));
+            }
+        }
+        for (auto station = 0; station < DAY_STATIONS; ++station) {
+            for (auto state = 0; state < 3; ++state) {
+                times.push_back(fleet.getTimeInState(station, static_cast<StationState>(state)));
+            }
+        }
+        for (auto site = 0; site < DAY_TRUCKS; ++site) {
+            times.push_back(fleet.getIdleTime(site));
+            times.push_back(fleet.getMiningTime(site));
+        }
+        return times;
+    }
 };
 
 /// Tests MineTimer functionality
-/// \note   Will sometimes fail, because two random numbers will randomly be the same
+/// \note   The default stream is fixed, so whether two draws in a row are the same is too
 TEST_F(AcmeMinerTest, InstantiatingMineTimerWithDefaultValuesShouldWork) {
     auto duration1 = (*myMineTimer)();
     EXPECT_TRUE(duration1 >= H3_MINING_MIN && duration1 <= H3_MINING_MAX);
@@ -137,23 +295,763 @@ TEST_F(AcmeMinerTest, MineStationStateTransitionsShouldWorkAsExpected) {
     EXPECT_TRUE(myMineStation1->getQueueSize() != 0);
 
     auto tick = 1;
-    std::string timestamp = tickToTimestamp(tick);
-    myMineTruckA->update(timestamp);
-    myMineStation1->update(timestamp);
+    myMineTruckA->update(tick);
+    myMineStation1->update(tick);
     EXPECT_EQ(myMineStation1->getState(), StationState::READY);
 
     for (auto i = 1; i < TRUCK_TRANSIT_TIME; ++i) {
         ++tick;
-        timestamp = tickToTimestamp(tick);
-        myMineTruckA->update(timestamp);
-        myMineStation1->update(timestamp);
+        myMineTruckA->update(tick);
+        myMineStation1->update(tick);
     }
 
     EXPECT_EQ(myMineStation1->getState(), StationState::UNLOADING);
 
     ++tick;
-    timestamp = tickToTimestamp(tick);
-    myMineTruckA->update(timestamp);
-    myMineStation1->update(timestamp);
+    myMineTruckA->update(tick);
+    myMineStation1->update(tick);
     EXPECT_EQ(myMineStation1->getState(), StationState::READY);
+}
+
+/// Tests that timestamps are formatted as HH:MM:SS, within and beyond the mining day
+TEST_F(AcmeMinerTest, TickToTimestampShouldFormatHoursMinutesSeconds) {
+    EXPECT_STREQ(tickToTimestamp(0), "00:00:00");
+    EXPECT_STREQ(tickToTimestamp(TICKS_PER_HOUR + 1), "01:05:00");
+    EXPECT_STREQ(tickToTimestamp(TICKS_PER_DAY - 1), "71:55:00");
+    EXPECT_STREQ(tickToTimestamp(TICKS_PER_DAY + TICKS_PER_HOUR), "73:00:00");
+}
+
+/// Tests that both engines account for every tick of the day
+TEST_F(AcmeMinerTest, EnginesShouldAccountForEveryTickOfTheDay) {
+    for (auto engine : {SimEngine::TICK, SimEngine::EVENT}) {
+        MineRegistry::getInstance().reset();
+        runMiningDay(engine);
+    }
+}
+
+/// Tests that a throttled MinePacer holds ticks to their deadlines
+TEST_F(AcmeMinerTest, MinePacerShouldHoldTicksToTheirDeadlines) {
+    // One 5-minute tick every 2 ms
+    constexpr auto NUM_TICKS = 10;
+    auto start = std::chrono::steady_clock::now();
+    auto pacer = MinePacer(SECONDS_PER_TICK / 0.002);
+    EXPECT_TRUE(pacer.isThrottled());
+
+    for (auto tick = 0; tick <= NUM_TICKS; ++tick) {
+        pacer.awaitTick(tick);
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start, NUM_TICKS * std::chrono::milliseconds(2));
+
+    EXPECT_FALSE(MinePacer(0).isThrottled());
+}
+
+/// Tests that MineRingQueue stays first-in, first-out while wrapping around and growing
+TEST_F(AcmeMinerTest, MineRingQueueShouldStayFirstInFirstOut) {
+    MineRingQueue<int> ringQueue;
+    auto next = 0;
+    auto expected = 0;
+    for (auto round = 1; round <= 20; ++round) {
+        for (auto push = 0; push < round; ++push) {
+            ringQueue.push(next++);
+        }
+        for (auto pop = 0; pop < round / 2; ++pop) {
+            EXPECT_EQ(ringQueue.front(), expected);
+            EXPECT_EQ(ringQueue.pop(), expected++);
+        }
+    }
+    EXPECT_EQ(ringQueue.size(), static_cast<std::size_t>(next - expected));
+}
+
+/// Tests that the structure-of-arrays TruckFleet accounts for every tick of the day
+TEST_F(AcmeMinerTest, TruckFleetShouldAccountForEveryTickOfTheDay) {
+    constexpr int NUM_TRUCKS = 40;
+    constexpr int NUM_STATIONS = 3;
+
+    // Split across more workers than there are aligned partitions, so some are empty
+    auto workerPool = MineWorkerPool(4);
+    auto fleet = TruckFleet(NUM_TRUCKS, NUM_STATIONS, NUM_TRUCKS);
+    fleet.setWorkerPool(&workerPool);
+    fleet.startTrucksAtMines();
+    auto pacer = MinePacer(0);
+    fleet.run(pacer);
+
+    for (auto truck = 0; truck < NUM_TRUCKS; ++truck) {
+        auto ticks = fleet.getTimeInState(truck, TruckState::MINING)
+                     + fleet.getTimeInState(truck, TruckState::INBOUND)
+                     + fleet.getTimeInState(truck, TruckState::QUEUED)
+                     + fleet.getTimeInState(truck, TruckState::UNLOADING)
+                     + fleet.getTimeInState(truck, TruckState::OUTBOUND);
+        EXPECT_EQ(ticks, TICKS_PER_DAY);
+        EXPECT_GT(fleet.getTimeInState(truck, TruckState::UNLOADING), 0);
+    }
+
+    for (auto station = 0; station < NUM_STATIONS; ++station) {
+        auto ticks = fleet.getTimeInState(station, StationState::IDLE)
+                     + fleet.getTimeInState(station, StationState::READY)
+                     + fleet.getTimeInState(station, StationState::UNLOADING);
+        EXPECT_EQ(ticks, TICKS_PER_DAY);
+    }
+
+    for (auto site = 0; site < NUM_TRUCKS; ++site) {
+        EXPECT_EQ(fleet.getIdleTime(site) + fleet.getMiningTime(site), TICKS_PER_DAY);
+    }
+}
+
+/// Tests that every MineWorkerPool worker runs each task exactly once
+TEST_F(AcmeMinerTest, MineWorkerPoolShouldRunEveryWorkerOncePerTask) {
+    auto workerPool = MineWorkerPool(3);
+    ASSERT_EQ(workerPool.size(), 3);
+
+    std::vector<int> runs(workerPool.size(), 0);
+    for (auto task = 0; task < 100; ++task) {
+        workerPool.run([&runs](int worker) { ++runs[worker]; });
+    }
+    for (auto count : runs) {
+        EXPECT_EQ(count, 100);
+    }
+}
+
+/// Tests that a Monte Carlo batch summarises the same days whatever the number of workers
+TEST_F(AcmeMinerTest, MineReplicationsShouldNotDependOnTheNumberOfWorkers) {
+    constexpr int NUM_TRUCKS = 12;
+    constexpr int NUM_STATIONS = 2;
+    constexpr int NUM_REPLICATIONS = 6;
+    constexpr std::uint64_t BASE_SEED = 20240601;
+
+    auto summarise = [](int numWorkers) {
+        auto path = ::testing::TempDir() + "replications" + std::to_string(numWorkers);
+
+        auto workerPool = MineWorkerPool(numWorkers);
+        auto replications =
+            MineReplications(NUM_TRUCKS, NUM_STATIONS, NUM_REPLICATIONS, BASE_SEED);
+        replications.run(workerPool);
+        replications.outputSummary(path);
+
+        std::ifstream input(path + "_Replications.csv");
+        return std::string(std::istreambuf_iterator<char>(input), {});
+    };
+
+    auto summary = summarise(1);
+    EXPECT_EQ(summary, summarise(3));
+
+    // A header, then 5 rows per truck, 3 per station and 2 per site
+    auto rows = std::count(summary.begin(), summary.end(), '\n');
+    EXPECT_EQ(rows, 1 + NUM_TRUCKS * 5 + NUM_STATIONS * 3 + NUM_TRUCKS * 2);
+    EXPECT_EQ(summary.rfind("Entity,Measure,Mean,Variance,CI95Low,CI95High\n", 0), 0U);
+}
+
+/// Tests that a MineTimer stream is replayed exactly from its seed, and differs between streams
+TEST_F(AcmeMinerTest, SeededMineTimersShouldReplayTheirStreams) {
+    auto timer1 = MineTimer(H3_MINING_MIN, H3_MINING_MAX, 42, 7);
+    auto timer2 = MineTimer(H3_MINING_MIN, H3_MINING_MAX, 42, 7);
+    auto timer3 = MineTimer(H3_MINING_MIN, H3_MINING_MAX, 42, 8);
+
+    auto differences = 0;
+    for (auto visit = 0; visit < 100; ++visit) {
+        auto duration = timer1();
+        EXPECT_TRUE(duration >= H3_MINING_MIN && duration <= H3_MINING_MAX);
+        EXPECT_EQ(duration, timer2());
+        differences += duration != timer3();
+    }
+    EXPECT_GT(differences, 50);
+}
+
+/// Tests that every engine, with any number of workers, simulates the same day from the same seed
+TEST_F(AcmeMinerTest, SeededEnginesShouldProduceIdenticalStatistics) {
+    constexpr std::uint64_t SEED = 1234567;
+
+    auto times = runMiningDay(SimEngine::TICK, SEED);
+    MineRegistry::getInstance().reset();
+    EXPECT_EQ(times, runMiningDay(SimEngine::EVENT, SEED));
+    EXPECT_EQ(times, runFleetDay(SEED, 1));
+    EXPECT_EQ(times, runFleetDay(SEED, 4));
+
+    MineRegistry::getInstance().reset();
+    EXPECT_NE(times, runMiningDay(SimEngine::TICK, SEED + 1));
+}
+
+/// Tests that the engines simulate the same day as updating every MineMinion on every tick
+TEST_F(AcmeMinerTest, EnginesShouldMatchUpdatingEveryMinionOnEveryTick) {
+    for (auto seed : {std::uint64_t{0}, std::uint64_t{7654321}}) {
+        auto reference = runMiningDay(SimEngine::EVENT, seed, true);
+        MineRegistry::getInstance().reset();
+        EXPECT_EQ(reference, runMiningDay(SimEngine::EVENT, seed));
+        MineRegistry::getInstance().reset();
+        EXPECT_EQ(reference, runMiningDay(SimEngine::TICK, seed));
+        MineRegistry::getInstance().reset();
+    }
+}
+
+/// Tests that a MineLogRing hands every record from several producers to one consumer, in order
+TEST_F(AcmeMinerTest, MineLogRingShouldDeliverEveryRecordInProducerOrder) {
+    constexpr int NUM_PRODUCERS = 3;
+    constexpr int NUM_RECORDS = 20000;
+
+    auto ring = MineLogRing<int>(8);
+    for (auto record = 0; record < 8; ++record) {
+        EXPECT_TRUE(ring.tryPush(int{record}));
+    }
+    EXPECT_FALSE(ring.tryPush(8));
+    for (int record = 0, value = 0; record < 8; ++record) {
+        ASSERT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, record);
+    }
+
+    std::vector<std::thread> producers;
+    for (auto producer = 0; producer < NUM_PRODUCERS; ++producer) {
+        producers.emplace_back([&ring, producer] {
+            for (auto record = 0; record < NUM_RECORDS; ++record) {
+                while (!ring.tryPush(producer * NUM_RECORDS + record)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(NUM_PRODUCERS, 0);
+    for (int received = 0, value = 0; received < NUM_PRODUCERS * NUM_RECORDS;) {
+        if (ring.tryPop(value)) {
+            auto producer = value / NUM_RECORDS;
+            EXPECT_EQ(value % NUM_RECORDS, next[producer]++);
+            ++received;
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_FALSE(ring.tryPop(next[0]));
+}
+
+/// Tests that MineLogger filters by level, category and entity before anything is formatted
+TEST_F(AcmeMinerTest, MineLoggerShouldFilterByLevelCategoryAndEntity) {
+    auto& logger = MineLogger::getInstance();
+    logger.setLevel(LogCategory::TRUCK, LogLevel::WARNING);
+    logger.setSampleRate(1000);
+
+    EXPECT_TRUE(logger.isEnabled(LogLevel::ERROR, LogCategory::TRUCK, 2000));
+    EXPECT_FALSE(logger.isEnabled(LogLevel::INFO, LogCategory::TRUCK, 2000));
+    EXPECT_FALSE(logger.isEnabled(LogLevel::ERROR, LogCategory::TRUCK, 1999));
+    EXPECT_TRUE(logger.isEnabled(LogLevel::INFO, LogCategory::STATION, 0));
+    EXPECT_FALSE(logger.isEnabled(LogLevel::DEBUG, LogCategory::DISPATCHER, 0));
+
+    auto formatted = 0;
+    auto format = [&formatted] {
+        ++formatted;
+        return "Logged while testing the filters";
+    };
+    ACME_LOG(INFO, TRUCK, 0, format());
+    ACME_LOG(WARNING, TRUCK, 1, format());
+    EXPECT_EQ(formatted, 0);
+    ACME_LOG(WARNING, TRUCK, 0, format());
+    EXPECT_EQ(formatted, 1);
+
+    logger.setLevel(LogCategory::TRUCK, LogLevel::INFO);
+    logger.setSampleRate(1);
+}
+
+/// Tests that replaying a MineJournal rebuilds the statistics of the day that wrote it
+TEST_F(AcmeMinerTest, MineJournalReplayShouldRebuildTheStatistics) {
+    constexpr int NUM_TRUCKS = 24;
+    constexpr int NUM_STATIONS = 3;
+    auto fileName = ::testing::TempDir() + "MineJournal.bin";
+
+    auto workerPool = MineWorkerPool(4);
+    auto fleet = TruckFleet(NUM_TRUCKS, NUM_STATIONS, NUM_TRUCKS, 99);
+    {
+        auto journal = MineJournal(fileName, NUM_TRUCKS, NUM_STATIONS, NUM_TRUCKS, 99);
+        fleet.setJournal(&journal);
+        fleet.setWorkerPool(&workerPool);
+        fleet.startTrucksAtMines();
+        auto pacer = MinePacer(0);
+        fleet.run(pacer);
+        journal.close();
+    }
+
+    auto reader = MineJournalReader(fileName);
+    EXPECT_EQ(reader.getHeader().numTrucks, static_cast<std::uint32_t>(NUM_TRUCKS));
+    EXPECT_EQ(reader.getHeader().seed, 99U);
+    auto replay = MineJournalReplay(reader);
+
+    for (auto truck = 0; truck < NUM_TRUCKS; ++truck) {
+        for (auto state = 0; state < 5; ++state) {
+            auto truckState = static_cast<TruckState>(state);
+            EXPECT_EQ(
+                replay.getTimeInState(truck, truckState), fleet.getTimeInState(truck, truckState));
+        }
+    }
+    for (auto station = 0; station < NUM_STATIONS; ++station) {
+        for (auto state = 0; state < 3; ++state) {
+            auto stationState = static_cast<StationState>(state);
+            EXPECT_EQ(
+                replay.getTimeInState(station, stationState),
+                fleet.getTimeInState(station, stationState));
+        }
+    }
+    for (auto site = 0; site < NUM_TRUCKS; ++site) {
+        EXPECT_EQ(replay.getIdleTime(site), fleet.getIdleTime(site));
+        EXPECT_EQ(replay.getMiningTime(site), fleet.getMiningTime(site));
+    }
+
+    // A journal that cannot be written, or holds a state this build does not know, is an error
+    EXPECT_THROW(
+        MineJournal(::testing::TempDir() + "missing/MineJournal.bin", 1, 1, 1, 0),
+        std::runtime_error);
+    {
+        auto journal = MineJournal(fileName, 1, 1, 1, 0);
+        journal.enterState(0, 0, static_cast<TruckState>(NUM_TRUCK_STATES));
+        journal.close();
+    }
+    EXPECT_THROW(MineJournalReplay(MineJournalReader(fileName)), std::runtime_error);
+    std::remove(fileName.c_str());
+}
+
+/// Tests that the CSV sink writes one sorted row per entity, and the null sink only counts them
+TEST_F(AcmeMinerTest, MineStatsSinksShouldWriteOrCountEveryRow) {
+    constexpr int NUM_TRUCKS = 12;
+    constexpr int NUM_STATIONS = 2;
+    auto path = ::testing::TempDir() + "stats";
+
+    auto fleet = TruckFleet(NUM_TRUCKS, NUM_STATIONS, NUM_TRUCKS, 7);
+    fleet.startTrucksAtMines();
+    auto pacer = MinePacer(0);
+    fleet.run(pacer);
+    {
+        auto stats = MineCsvStatsSink(path);
+        fleet.outputStatistics(stats);
+    }
+
+    auto readLines = [&path](const char* suffix) {
+        std::ifstream input(path + suffix);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(input, line);) {
+            lines.push_back(line);
+        }
+        return lines;
+    };
+
+    auto trucks = readLines("_MineTruck.csv");
+    ASSERT_EQ(trucks.size(), 1U + NUM_TRUCKS);
+    EXPECT_EQ(trucks[0], "Truck,Mining,Inbound,Queued,Unloading,Outbound");
+    auto expected = genMinionName("ATRK", 11);
+    for (auto state = 0; state < 5; ++state) {
+        auto ticks = fleet.getTimeInState(11, static_cast<TruckState>(state));
+        expected += "," + std::to_string(ticks * TICK_DURATION);
+    }
+    EXPECT_EQ(trucks[12], expected);
+
+    EXPECT_EQ(readLines("_MineStation.csv").size(), 1U + NUM_STATIONS);
+    EXPECT_EQ(readLines("_MineSite.csv").size(), 1U + NUM_TRUCKS);
+
+    // Visits are totalled per truck and station, in that order
+    auto visits = readLines("_StationVisits.csv");
+    ASSERT_GT(visits.size(), 1U);
+    EXPECT_EQ(visits[0], "Truck,Site,Visits");
+    EXPECT_TRUE(std::is_sorted(visits.begin() + 1, visits.end()));
+    EXPECT_EQ(std::adjacent_find(visits.begin(), visits.end()), visits.end());
+
+    auto nullStats = MineNullStatsSink();
+    fleet.outputStatistics(nullStats);
+    nullStats.close();
+    EXPECT_GE(nullStats.getNumRows(), NUM_TRUCKS + NUM_STATIONS + NUM_TRUCKS + visits.size() - 1);
+}
+
+/// Tests that a MineIndexedHeap holds each item once, and finds the minimum as keys change
+TEST_F(AcmeMinerTest, MineIndexedHeapShouldTrackKeysUpdatedInPlace) {
+    constexpr int NUM_ITEMS = 2000;
+    auto heap = MineIndexedHeap<>();
+    std::vector<std::int32_t> keys(NUM_ITEMS, 0);
+    for (auto item = 0; item < NUM_ITEMS; ++item) {
+        heap.push(item, 0);
+    }
+    EXPECT_EQ(heap.top(), 0);
+
+    // Ties go to the smallest item; keys move up and down like station queue sizes
+    auto timer = MineTimer(-3, 3, 11);
+    for (auto step = 0; step < 20000; ++step) {
+        auto item = heap.top();
+        if (step % 2 != 0) {
+            item = (step * 7919) % NUM_ITEMS;
+        }
+        keys[item] = std::max(0, keys[item] + timer());
+        heap.update(item, keys[item]);
+
+        auto smallest = std::min_element(keys.begin(), keys.end()) - keys.begin();
+        ASSERT_EQ(heap.top(), smallest);
+    }
+    EXPECT_EQ(heap.size(), static_cast<std::size_t>(NUM_ITEMS));
+}
+
+/// Tests that a MinePool places its objects side by side, and destroys them in reverse order
+TEST_F(AcmeMinerTest, MinePoolShouldPlaceObjectsSideBySide) {
+    std::vector<int> destroyed;
+    struct Tracked {
+        Tracked(int id, std::vector<int>& destroyed)
+            : id(id)
+            , destroyed(destroyed) {}
+        ~Tracked() {
+            destroyed.push_back(id);
+        }
+        int id;
+        std::vector<int>& destroyed;
+    };
+
+    {
+        auto pool = MinePool<Tracked>(3);
+        auto* first = pool.emplace(0, destroyed);
+        pool.emplace(1, destroyed);
+        auto* last = pool.emplace(2, destroyed);
+        EXPECT_EQ(last - first, 2);
+        EXPECT_EQ(pool.size(), pool.capacity());
+
+        // Moving the pool leaves the objects where they are
+        auto moved = std::move(pool);
+        EXPECT_EQ(&moved[2], last);
+        EXPECT_TRUE(destroyed.empty());
+    }
+    EXPECT_EQ(destroyed, (std::vector<int>{2, 1, 0}));
+
+    EXPECT_EQ(genMinionName("ATRK", 42), "ATRK-000042");
+    EXPECT_EQ(genMinionName("ASTN", 1234567), "ASTN-1234567");
+}
+
+/// Tests that a MineTimingWheel hands out every item on its own tick, across every level
+TEST_F(AcmeMinerTest, MineTimingWheelShouldCollectItemsOnTheirTick) {
+    constexpr int NUM_TICKS = 70000;
+    auto wheel = MineTimingWheel<int>();
+    auto timer = MineTimer(1, 5000, 13);
+    std::vector<int> due;
+    auto numScheduled = std::size_t{0};
+
+    // Items scheduled from within a tick, some of them far enough ahead to start on a high level
+    for (auto tick = 0; tick < NUM_TICKS; ++tick) {
+        due.clear();
+        wheel.collect(due);
+        for (auto item : due) {
+            ASSERT_EQ(item, tick);
+        }
+        if (tick % 3 == 0) {
+            auto delay = tick % 9 == 0 ? timer() : 1 + tick % 7;
+            wheel.schedule(tick + delay, tick + delay);
+            wheel.schedule(tick + delay, tick + delay);
+            numScheduled += 2;
+        }
+        numScheduled -= due.size();
+        ASSERT_EQ(wheel.size(), numScheduled);
+    }
+    EXPECT_EQ(wheel.now(), NUM_TICKS);
+    EXPECT_FALSE(wheel.empty());
+}
+
+/// Tests that a MineStation is woken when a MineTruck joins, reaches and leaves it, and accounts
+/// for the ticks it slept through
+TEST_F(AcmeMinerTest, MineStationShouldSleepUntilWoken) {
+    struct RecordingWaker : public MineStationWaker {
+        void wakeStation(MineStation& mineStation) override {
+            woken.push_back(&mineStation);
+        }
+        std::vector<MineStation*> woken;
+    };
+    auto waker = RecordingWaker();
+    MineRegistry::getInstance().setStationWaker(&waker);
+    MineRegistry::getInstance().getStationDispatcher()->enqueue(myMineStation1);
+
+    // Joining the queue wakes the IDLE MineStation
+    myMineTruckA->assignMineSite(myMineSiteA);
+    myMineTruckA->setTruckState(TruckState::INBOUND);
+    ASSERT_EQ(waker.woken.size(), 1u);
+    auto tick = 0;
+    myMineStation1->update(tick);
+    EXPECT_EQ(myMineStation1->getState(), StationState::READY);
+
+    // It sleeps through the transit, until the MineTruck reaches it
+    while (myMineTruckA->getTruckState() == TruckState::INBOUND) {
+        myMineTruckA->update(++tick);
+    }
+    ASSERT_EQ(waker.woken.size(), 2u);
+    myMineStation1->update(tick);
+    EXPECT_EQ(myMineStation1->getState(), StationState::UNLOADING);
+    EXPECT_EQ(myMineStation1->getTimeInState(StationState::IDLE), 1);
+    EXPECT_EQ(myMineStation1->getTimeInState(StationState::READY), TRUCK_TRANSIT_TIME);
+
+    // Leaving the queue wakes it once more
+    while (myMineTruckA->getTruckState() == TruckState::QUEUED) {
+        myMineTruckA->update(++tick);
+    }
+    EXPECT_EQ(waker.woken, (std::vector<MineStation*>(3, myMineStation1)));
+    MineRegistry::getInstance().setStationWaker(nullptr);
+}
+
+/// Tests that a MineSite accumulates its idle and mining ticks from the ticks its flag changes at
+TEST_F(AcmeMinerTest, MineSiteShouldAccountForTicksBetweenFlagChanges) {
+    // Mined from the first tick, even though the flag was set while setting up
+    myMineSiteA->setMiningFlag(true, -1);
+    myMineSiteA->setMiningFlag(false, 10);
+    myMineSiteA->setMiningFlag(true, 16);
+    EXPECT_EQ(myMineSiteA->getMiningCount(), 10);
+    EXPECT_EQ(myMineSiteA->getIdleCount(), 6);
+
+    myMineSiteA->update(TICKS_PER_DAY - 1);
+    EXPECT_EQ(myMineSiteA->getMiningCount(), TICKS_PER_DAY - 6);
+    EXPECT_EQ(myMineSiteA->getIdleCount(), 6);
+
+    // Updating on every tick counts the same ticks
+    for (auto tick = 0; tick < TICKS_PER_DAY; ++tick) {
+        if (tick == 10 || tick == 16) {
+            myMineSiteB->setMiningFlag(tick == 16, tick);
+        }
+        myMineSiteB->update(tick);
+    }
+    EXPECT_EQ(myMineSiteB->getMiningCount(), TICKS_PER_DAY - 16);
+    EXPECT_EQ(myMineSiteB->getIdleCount(), 16);
+}
+
+/// Tests that the object engines and TruckFleet count the same transitions and dispatches
+TEST_F(AcmeMinerTest, MineMetricsShouldCountTheSameEventsInEveryEngine) {
+    constexpr std::uint64_t SEED = 42;
+    auto& metrics = MineMetrics::getInstance();
+    auto sameCounts = [](const MineMetricCounts& lhs, const MineMetricCounts& rhs) {
+        return lhs.truckTransitions == rhs.truckTransitions
+               && lhs.stationTransitions == rhs.stationTransitions
+               && lhs.dispatchOps == rhs.dispatchOps;
+    };
+
+    metrics.reset();
+    runMiningDay(SimEngine::EVENT, SEED);
+    auto counts = metrics.getCounts();
+    EXPECT_GT(metrics.getPhaseMs(MetricPhase::TICK_UPDATE), 0);
+    EXPECT_GE(counts.truckTransitions[index(TruckState::MINING)], DAY_TRUCKS);
+    EXPECT_EQ(
+        counts.dispatchOps[static_cast<std::size_t>(DispatchOp::STATION_SELECT)],
+        counts.truckTransitions[index(TruckState::INBOUND)]);
+
+    metrics.reset();
+    runFleetDay(SEED, 4);
+    EXPECT_TRUE(sameCounts(counts, metrics.getCounts()));
+    metrics.reset();
+}
+
+/// Tests that MineTrace records spans only while enabled, and writes those of every thread
+TEST_F(AcmeMinerTest, MineTraceShouldWriteTheSpansOfEveryThread) {
+    auto fileName = ::testing::TempDir() + "MineTrace.json";
+    auto& trace = MineTrace::getInstance();
+    auto numSpans = trace.getNumSpans();
+    {
+        auto span = MineTraceSpan("disabled");
+    }
+    EXPECT_EQ(trace.getNumSpans(), numSpans);
+
+    trace.enable();
+    trace.setThreadName("test");
+    {
+        auto span = MineTraceSpan("outer");
+        std::thread worker([&trace] {
+            trace.setThreadName("test worker");
+            auto span = MineTraceSpan("inner");
+        });
+        worker.join();
+    }
+    EXPECT_EQ(trace.getNumSpans(), numSpans + 2);
+    trace.writeJson(fileName);
+    EXPECT_FALSE(MineTrace::isEnabled());
+
+    std::ifstream input(fileName);
+    std::string json((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    EXPECT_NE(json.find("\"name\": \"outer\", \"ph\": \"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\": \"inner\", \"ph\": \"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\": {\"name\": \"test worker\"}"), std::string::npos);
+    EXPECT_EQ(json.find("disabled"), std::string::npos);
+    input.close();
+    std::remove(fileName.c_str());
+}
+
+/// Tests that, with logging off, neither the event engine nor TruckFleet allocates once the first
+/// half of the day has grown every buffer to its working size
+TEST_F(AcmeMinerTest, SteadyStateTicksShouldNotAllocate) {
+    constexpr int WARM_UP = TICKS_PER_DAY / 2;
+    auto& logger = MineLogger::getInstance();
+    for (std::size_t category = 0; category < NUM_LOG_CATEGORIES; ++category) {
+        logger.setLevel(static_cast<LogCategory>(category), LogLevel::OFF);
+    }
+
+    // Runs the ticks of a day, and reports the allocations of its second half by call site
+    auto& allocCounter = MineAllocCounter::getInstance();
+    auto countSteadyState = [&allocCounter](const auto& tick) {
+        for (auto now = 0; now < WARM_UP; ++now) {
+            tick(now);
+        }
+        allocCounter.reset();
+        allocCounter.start();
+        for (auto now = WARM_UP; now < TICKS_PER_DAY; ++now) {
+            tick(now);
+        }
+        allocCounter.stop();
+        std::ostringstream report;
+        allocCounter.report(report, TICKS_PER_DAY - WARM_UP);
+        return report.str();
+    };
+
+    for (auto fixedTick : {true, false}) {
+        MineRegistry::getInstance().reset();
+        auto overlord = MineOverlord();
+        auto trucks = instantiateTrucks(overlord, DAY_TRUCKS);
+        auto stations = instantiateStations(overlord, DAY_STATIONS);
+        auto sites = instantiateSites(overlord, DAY_TRUCKS, 0);
+        std::vector<MineMinion*> minions;
+        for (auto& truck : trucks) {
+            minions.push_back(&truck);
+        }
+        for (auto& station : stations) {
+            minions.push_back(&station);
+        }
+        for (auto& site : sites) {
+            minions.push_back(&site);
+        }
+        startTrucksAtMines();
+
+        auto engine = MineEventEngine(minions, fixedTick);
+        auto pacer = MinePacer(0);
+        auto report = countSteadyState([&engine, &pacer](int now) { engine.tick(now, pacer); });
+        EXPECT_EQ(allocCounter.getCount(), 0u) << report;
+    }
+
+    for (auto numWorkers : {1, 2}) {
+        auto workerPool = MineWorkerPool(numWorkers);
+        auto fleet = TruckFleet(DAY_TRUCKS, DAY_STATIONS, DAY_TRUCKS);
+        fleet.setWorkerPool(&workerPool);
+        fleet.startTrucksAtMines();
+        auto report = countSteadyState([&fleet](int now) { fleet.tick(now); });
+        EXPECT_EQ(allocCounter.getCount(), 0u) << report;
+    }
+
+    for (std::size_t category = 0; category < NUM_LOG_CATEGORIES; ++category) {
+        logger.setLevel(static_cast<LogCategory>(category), LogLevel::INFO);
+    }
+}
+
+/// Tests that a TruckFleet day resumed from a checkpoint ends as if it had never been interrupted
+TEST_F(AcmeMinerTest, TruckFleetShouldResumeFromACheckpointWithIdenticalResults) {
+    constexpr int CHECKPOINT_TICK = TICKS_PER_DAY / 3;
+    auto fileName = ::testing::TempDir() + "MineCheckpoint.bin";
+    auto expected = runFleetDay(31, 1);
+
+    // The day that writes the checkpoint carries on unchanged
+    auto workerPool = MineWorkerPool(2);
+    auto pacer = MinePacer(0);
+    auto fleet = TruckFleet(DAY_TRUCKS, DAY_STATIONS, DAY_TRUCKS, 31);
+    fleet.startTrucksAtMines();
+    fleet.run(pacer, CHECKPOINT_TICK);
+    fleet.writeCheckpoint(fileName);
+    fleet.run(pacer);
+    EXPECT_EQ(getFleetTimes(fleet), expected);
+
+    // The resumed fleet's own seed and worker count are irrelevant
+    auto resumed = TruckFleet(DAY_TRUCKS, DAY_STATIONS, DAY_TRUCKS, 0);
+    resumed.setWorkerPool(&workerPool);
+    resumed.readCheckpoint(fileName);
+    EXPECT_EQ(resumed.getNextTick(), CHECKPOINT_TICK);
+    EXPECT_EQ(resumed.getSeed(), 31U);
+    resumed.run(pacer);
+    EXPECT_EQ(getFleetTimes(resumed), expected);
+
+    auto smaller = TruckFleet(DAY_TRUCKS - 1, DAY_STATIONS, DAY_TRUCKS, 31);
+    EXPECT_THROW(smaller.readCheckpoint(fileName), std::runtime_error);
+
+    // A truck state this build does not know is rejected, rather than used as an index
+    {
+        std::fstream file(fileName, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(sizeof(CheckpointHeader) + sizeof(std::uint64_t));
+        file.put(static_cast<char>(NUM_TRUCK_STATES));
+    }
+    auto corrupt = TruckFleet(DAY_TRUCKS, DAY_STATIONS, DAY_TRUCKS, 0);
+    EXPECT_THROW(corrupt.readCheckpoint(fileName), std::runtime_error);
+    std::remove(fileName.c_str());
+}
+
+/// Tests that forked what-if branches each finish the day from the branch tick, with their changes
+TEST_F(AcmeMinerTest, MineBranchesShouldRunEachWhatIfFromTheBranchTick) {
+    constexpr int BRANCH_TICK = TICKS_PER_DAY / 2;
+    auto runToBranch = [](TruckFleet& fleet, MinePacer& pacer) {
+        fleet.startTrucksAtMines();
+        fleet.run(pacer, BRANCH_TICK);
+    };
+
+    auto pacer = MinePacer(0);
+    auto fleet = TruckFleet(DAY_TRUCKS, DAY_STATIONS, DAY_TRUCKS, 17);
+    runToBranch(fleet, pacer);
+    auto branches = MineBranches({{"stations+2", 2, 0, 0}, {"trucks-3,transit=4", 0, 3, 4}});
+    branches.run(fleet, pacer);
+    const auto& summaries = branches.getSummaries();
+    ASSERT_EQ(summaries.size(), 3U);
+
+    // The branches leave the parent's fleet at the branch tick
+    EXPECT_EQ(fleet.getNextTick(), BRANCH_TICK);
+    fleet.run(pacer);
+    auto unchanged = fleet.getSummary();
+    EXPECT_EQ(summaries[0].deliveries, unchanged.deliveries);
+    EXPECT_EQ(summaries[0].queuedTicks, unchanged.queuedTicks);
+    EXPECT_EQ(summaries[0].stationTicks, DAY_STATIONS * TICKS_PER_DAY);
+
+    // Added stations are in the day from the branch tick on
+    EXPECT_EQ(summaries[1].numStations, DAY_STATIONS + 2);
+    EXPECT_EQ(
+        summaries[1].stationTicks,
+        summaries[0].stationTicks + 2 * (TICKS_PER_DAY - BRANCH_TICK));
+
+    // A branch is the same day as making its changes in-process
+    auto changed = TruckFleet(DAY_TRUCKS, DAY_STATIONS, DAY_TRUCKS, 17);
+    runToBranch(changed, pacer);
+    changed.withdrawTrucks(3);
+    changed.setTransitTime(4);
+    changed.run(pacer);
+    auto expected = changed.getSummary();
+    EXPECT_EQ(summaries[2].numTrucks, DAY_TRUCKS - 3);
+    EXPECT_EQ(summaries[2].deliveries, expected.deliveries);
+    EXPECT_EQ(summaries[2].queuedTicks, expected.queuedTicks);
+    EXPECT_EQ(summaries[2].miningTicks, expected.miningTicks);
+    EXPECT_EQ(summaries[2].siteTicks, DAY_TRUCKS * TICKS_PER_DAY);
+}
+
+/// Tests that the sweep runs one day per valid grid point, and the same days on any number of
+/// workers
+TEST_F(AcmeMinerTest, MineSweepShouldRunEveryGridPointOnAnyNumberOfWorkers) {
+    MineSweepGrid grid;
+    grid.trucks = {4, 12, 4};
+    grid.stations = {1, 2, 1};
+    grid.sites = {0, 8, 8};
+    constexpr int MINING_STEP = H3_MINING_MAX - H3_MINING_MIN;
+    grid.miningMin = {H3_MINING_MIN, H3_MINING_MAX + MINING_STEP, MINING_STEP};
+    auto oneWorker = MineSweep(grid, 23);
+    auto threeWorkers = MineSweep(grid, 23);
+
+    // (3 truck counts with a site each, and 2 with 8 sites) * 2 stations * 2 of the 3 mining
+    // minimums, as the last one is above the maximum
+    const auto& points = oneWorker.getPoints();
+    ASSERT_EQ(points.size(), 20U);
+    for (const auto& point : points) {
+        EXPECT_GE(point.numSites, point.numTrucks);
+        EXPECT_LE(point.durations.miningMin, point.durations.miningMax);
+    }
+
+    auto pool = MineWorkerPool(1);
+    oneWorker.run(pool);
+    auto threePool = MineWorkerPool(3);
+    threeWorkers.run(threePool);
+    const auto& summaries = oneWorker.getSummaries();
+    ASSERT_EQ(summaries.size(), points.size());
+    for (std::size_t point = 0; point < points.size(); ++point) {
+        EXPECT_EQ(summaries[point].deliveries, threeWorkers.getSummaries()[point].deliveries);
+        EXPECT_EQ(summaries[point].queuedTicks, threeWorkers.getSummaries()[point].queuedTicks);
+    }
+
+    // A point is the same day as a fleet constructed with its parameters
+    const auto& last = points.back();
+    auto fleet = TruckFleet(last.numTrucks, last.numStations, last.numSites, 23, last.durations);
+    fleet.startTrucksAtMines();
+    auto pacer = MinePacer(0);
+    fleet.run(pacer);
+    auto expected = fleet.getSummary();
+    EXPECT_EQ(summaries.back().numTrucks, 12);
+    EXPECT_EQ(summaries.back().deliveries, expected.deliveries);
+    EXPECT_EQ(summaries.back().miningTicks, expected.miningTicks);
+    EXPECT_EQ(summaries.back().siteTicks, 12 * TICKS_PER_DAY);
 }
\ No newline at end of file
@@ -3,14 +3,20 @@
 
 #include "MineDefs.h"
 #include "MineDispatchers.h"
+#include "MineLogger.h"
 #include "MineOverlord.h"
 #include "MineSite.h"
 #include "MineTruck.h"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <chrono>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <vector>
 
 namespace acme {
 /// Creates an ISO date stamp for stats output files
@@ -29,56 +35,94 @@ std::string createISODateStamp() {
     return oss.str();
 }
 
+/// Formats the prefix, a dash and the serial padded to 6 digits, as in ATRK-000042
+/// \param first
+/// \param prefix
+/// \param serial
+/// \return one past the last character written
+char* formatMinionName(char* first, const char* prefix, int serial) {
+    constexpr std::ptrdiff_t SERIAL_DIGITS = 6;
+    auto* next = first;
+    while (*prefix != '\0') {
+        *next++ = *prefix++;
+    }
+    *next++ = '-';
+
+    std::array<char, 16> digits{};
+    auto result = std::to_chars(digits.data(), digits.data() + digits.size(), serial);
+    for (auto length = result.ptr - digits.data(); length < SERIAL_DIGITS; ++length) {
+        *next++ = '0';
+    }
+    return std::copy(digits.data(), result.ptr, next);
+}
+
 /// Generates a standard name for a MineMinion
 /// \param prefix
 /// \param serial
 /// \return
 std::string genMinionName(const char* prefix, int serial) {
-    std::ostringstream oss;
-    oss << prefix << "-" << std::setw(6) << std::setfill('0') << serial;
-    return oss.str();
+    std::array<char, MAX_MINION_NAME> name{};
+    return std::string(name.data(), formatMinionName(name.data(), prefix, serial));
 }
 
 /// Instantiates all MineSite instances and attaches them as Observers
 /// \param overlord
 /// \param numSites
-void instantiateSites(MineOverlord& overlord, int numSites) {
+/// \param seed
+MinePool<MineSite> instantiateSites(MineOverlord& overlord, int numSites, std::uint64_t seed) {
+    auto sites = MinePool<MineSite>(numSites);
     auto siteDispatcher = MineRegistry::getInstance().getSiteDispatcher();
     for (auto site = 0; site < numSites; ++site) {
         constexpr char SITE_PREFIX[]{"ASIT"};
-        auto name = genMinionName(SITE_PREFIX, site);
-        auto* miningSite = new MineSite(name);
+        auto* miningSite = sites.emplace(genMinionName(SITE_PREFIX, site), site, seed);
         overlord.attach(miningSite);
         siteDispatcher->enqueue(miningSite);
     }
+    return sites;
 }
 
 /// Instantiates all MineStation instances and attaches them as Observers
 /// \param overlord
 /// \param numStations
-void instantiateStations(MineOverlord& overlord, int numStations) {
+MinePool<MineStation> instantiateStations(MineOverlord& overlord, int numStations) {
+    auto stations = MinePool<MineStation>(numStations);
     auto stationDispatcher = MineRegistry::getInstance().getStationDispatcher();
     for (auto station = 0; station < numStations; ++station) {
         constexpr char STATION_PREFIX[]{"ASTN"};
-        auto name = genMinionName(STATION_PREFIX, station);
-        auto* miningStation = new MineStation(name);
+        auto* miningStation = stations.emplace(genMinionName(STATION_PREFIX, station), station);
         overlord.attach(miningStation);
         stationDispatcher->enqueue(miningStation);
     }
+    return stations;
 }
 
 /// Instantiates all MineTruck instances and attaches them as Observers
 /// \param overlord
 /// \param numTrucks
-void instantiateTrucks(MineOverlord& overlord, int numTrucks) {
+MinePool<MineTruck> instantiateTrucks(MineOverlord& overlord, int numTrucks) {
+    auto trucks = MinePool<MineTruck>(numTrucks);
     auto truckDispatcher = MineRegistry::getInstance().getTruckDispatcher();
+    truckDispatcher->truckGarage.reserve(truckDispatcher->truckGarage.size() + numTrucks);
     for (auto truck = 0; truck < numTrucks; ++truck) {
         constexpr char TRUCK_PREFIX[]{"ATRK"};
-        auto name = genMinionName(TRUCK_PREFIX, truck);
-        auto* miningTruck = new MineTruck(name);
+        auto* miningTruck = trucks.emplace(genMinionName(TRUCK_PREFIX, truck), truck);
         overlord.attach(miningTruck);
         truckDispatcher->truckGarage.push_back(miningTruck);
     }
+    return trucks;
+}
+
+/// Logs the banner at the start of a simulation day
+/// \param numTrucks
+/// \param numStations
+/// \param seed
+void logSimulationHeader(int numTrucks, int numStations, std::uint64_t seed) {
+    std::ostringstream oss;
+    oss << "ACME Helium-3 Lunar Mining Operations : " << createISODateStamp() << " : ";
+    oss << numTrucks << " mining trucks, " << numStations << " unloading stations, seed " << seed;
+    MineLogger::getInstance().logMessage(oss.str());
+    std::string separator(oss.str().length(), '=');
+    MineLogger::getInstance().logMessage(separator);
 }
 
 /// Makes initial association of trucks with mines, sets initial truck state to MINING
@@ -92,10 +136,11 @@ void startTrucksAtMines() {
     }
 }
 
-/// Converts current tick to an HH:MM:SS timestamp
-/// \param tick
-/// \return
-std::string tickToTimestamp(int tick) {
+namespace {
+using Timestamp = std::array<char, 16>;
+
+/// Formats a tick as an HH:MM:SS timestamp
+void formatTimestamp(SimTime tick, Timestamp& timestamp) {
     auto numSeconds = tick * SECONDS_PER_TICK;
 
     auto hours = numSeconds / 3600;
@@ -104,9 +149,30 @@ std::string tickToTimestamp(int tick) {
     auto minutes = numSeconds / 60;
     auto seconds = numSeconds % 60;
 
-    std::ostringstream oss;
-    oss << std::setw(2) << std::setfill('0') << hours << ":" << std::setw(2) << std::setfill('0')
-        << minutes << ":" << std::setw(2) << std::setfill('0') << seconds;
-    return oss.str();
+    std::snprintf(timestamp.data(), timestamp.size(), "%02d:%02d:%02d", hours, minutes, seconds);
+}
+}  // namespace
+
+/// Converts a tick to an HH:MM:SS timestamp
+/// \note   The timestamps for the mining day are formatted once, up front, so that looking one up
+///         for a log line costs no formatting or allocation
+/// \param tick
+/// \return
+const char* tickToTimestamp(SimTime tick) {
+    static const auto timestamps = [] {
+        std::vector<Timestamp> table(TICKS_PER_DAY + 1);
+        for (SimTime entry = 0; entry <= TICKS_PER_DAY; ++entry) {
+            formatTimestamp(entry, table[entry]);
+        }
+        return table;
+    }();
+
+    if (tick >= 0 && tick <= TICKS_PER_DAY) {
+        return timestamps[tick].data();
+    }
+
+    thread_local Timestamp overflow;
+    formatTimestamp(tick, overflow);
+    return overflow.data();
 }
 }  // namespace acme
\ No newline at end of file
@@ -1,27 +1,45 @@
 /// \file   AcmeMinerUtils
 #pragma once
+#include "MineDefs.h"
+#include "MinePool.h"
+
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace acme {
 class MineOverlord;
+class MineSite;
+class MineStation;
+class MineTruck;
+
+/// Room for any name formatMinionName makes from a short prefix
+constexpr std::size_t MAX_MINION_NAME = 32;
+
 ///
 std::string createISODateStamp();
 
+/// Writes a standard MineMinion name, without a terminating null, and returns its end
+char* formatMinionName(char* first, const char* prefix, int serial);
+
 ///
 std::string genMinionName(const char* prefix, int serial);
 
-///
-void instantiateSites(MineOverlord& overlord, int numSites);
+/// Constructs every MineSite side by side; they live as long as the returned MinePool
+MinePool<MineSite> instantiateSites(MineOverlord& overlord, int numSites, std::uint64_t seed);
 
-///
-void instantiateStations(MineOverlord& overlord, int numStations);
+/// Constructs every MineStation side by side; they live as long as the returned MinePool
+MinePool<MineStation> instantiateStations(MineOverlord& overlord, int numStations);
+
+/// Constructs every MineTruck side by side; they live as long as the returned MinePool
+MinePool<MineTruck> instantiateTrucks(MineOverlord& overlord, int numTrucks);
 
 ///
-void instantiateTrucks(MineOverlord& overlord, int numTrucks);
+void logSimulationHeader(int numTrucks, int numStations, std::uint64_t seed);
 
 ///
 void startTrucksAtMines();
 
 ///
-std::string tickToTimestamp(int tick);
+const char* tickToTimestamp(SimTime tick);
 }  // namespace acme
\ No newline at end of file
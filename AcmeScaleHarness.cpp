@@ -0,0 +1,457 @@
+/// \file   AcmeScaleHarness.cpp
+/// \brief  Runs whole simulation days over a grid of fleet sizes, to find where AHLMO stops scaling
+#include "AcmeMinerUtils.h"
+#include "MineDispatchers.h"
+#include "MineLogger.h"
+#include "MineOptions.h"
+#include "MineOverlord.h"
+#include "MinePacer.h"
+#include "MineSetupMeter.h"
+#include "MineSite.h"
+#include "MineStation.h"
+#include "MineStatsSink.h"
+#include "MineTruck.h"
+#include "TruckFleet.h"
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace acme;
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+/// Engine names, in SimEngine order
+constexpr const char* ENGINE_NAMES[]{"tick", "event", "fleet"};
+
+/// Growth over the baseline allowed by the rows of a newly written baseline: twice the time per
+/// truck-tick, as machines differ, but only a quarter more memory
+constexpr double DEFAULT_TIME_TOLERANCE = 1.0;
+constexpr double DEFAULT_MEMORY_TOLERANCE = 0.25;
+
+///
+const char* scaleUsageMessage() {
+    return "Usage: acme-scale [--engines=<tick|event|fleet>,...] [--trucks=<N>,...] "
+           "[--stations=<M>,...]\n"
+           "                  [--output-dir=<dir>] [--report=<csv-file>] [--baseline=<csv-file>] "
+           "[--write-baseline=<csv-file>]";
+}
+
+/// One simulation day of the grid
+struct ScaleConfig {
+    SimEngine engine{SimEngine::FLEET};
+    int numTrucks{0};
+    int numStations{0};
+};
+
+/// What a simulation day measures of itself; it is handed from the child process to the harness
+struct PhaseTimes {
+    double setupMs{0};
+    double runMs{0};
+    double outputMs{0};
+    double bytesPerTruck{0};    // The fleet engine counts its whole footprint here
+    double bytesPerStation{0};  // 0 for the fleet engine
+    double bytesPerSite{0};     // 0 for the fleet engine
+};
+
+/// The measurements of a simulation day, with the peak resident set of its process
+struct ScaleResult {
+    ScaleConfig config;
+    PhaseTimes phases;
+    double wallMs{0};
+    long peakRssKiB{0};
+
+    double getNsPerTruckTick() const {
+        return phases.runMs * 1e6 / (static_cast<double>(config.numTrucks) * TICKS_PER_DAY);
+    }
+};
+
+/// The limits the results of a simulation day are checked against
+struct Baseline {
+    ScaleConfig config;
+    double nsPerTruckTick{0};
+    long peakRssKiB{0};
+    double bytesPerTruck{0};
+    double timeTolerance{DEFAULT_TIME_TOLERANCE};
+    double memoryTolerance{DEFAULT_MEMORY_TOLERANCE};
+};
+
+/// \throws std::invalid_argument if the name is unknown
+SimEngine parseEngine(const std::string& name) {
+    for (std::size_t engine = 0; engine < std::size(ENGINE_NAMES); ++engine) {
+        if (name == ENGINE_NAMES[engine]) {
+            return static_cast<SimEngine>(engine);
+        }
+    }
+    throw std::invalid_argument(name);
+}
+
+/// Splits a comma-separated list
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::istringstream iss(list);
+    for (std::string item; std::getline(iss, item, ',');) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+///
+std::vector<int> parseCounts(const std::string& list) {
+    std::vector<int> counts;
+    for (const auto& item : split(list)) {
+        counts.push_back(std::stoi(item));
+    }
+    return counts;
+}
+
+/// \throws std::runtime_error if the file cannot be read
+std::vector<Baseline> readBaseline(const std::string& path) {
+    std::ifstream input(path);
+    if (!input) {
+        throw std::runtime_error("Cannot read baseline " + path);
+    }
+
+    std::vector<Baseline> baseline;
+    std::string line;
+    std::getline(input, line);  // Header
+    while (std::getline(input, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        auto fields = split(line);
+        if (fields.size() != 8) {
+            throw std::runtime_error("Malformed baseline row: " + line);
+        }
+        Baseline row;
+        row.config = {parseEngine(fields[0]), std::stoi(fields[1]), std::stoi(fields[2])};
+        row.nsPerTruckTick = std::stod(fields[3]);
+        row.peakRssKiB = std::stol(fields[4]);
+        row.bytesPerTruck = std::stod(fields[5]);
+        row.timeTolerance = std::stod(fields[6]);
+        row.memoryTolerance = std::stod(fields[7]);
+        baseline.push_back(row);
+    }
+    return baseline;
+}
+
+///
+double elapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+/// Sets up, runs and outputs one simulation day, timing each phase and weighing each kind of
+/// entity; the CSV files are named after csvStamp
+PhaseTimes runDay(const ScaleConfig& config, const std::string& csvStamp) {
+    PhaseTimes phases;
+    auto numSites = config.numTrucks;
+    auto heapInUse = MineSetupMeter::getHeapInUse();
+    auto bytesEach = [&heapInUse](int count) {
+        auto previous = heapInUse;
+        heapInUse = MineSetupMeter::getHeapInUse();
+        return heapInUse > previous ? static_cast<double>(heapInUse - previous) / count : 0.0;
+    };
+
+    auto start = Clock::now();
+    if (config.engine == SimEngine::FLEET) {
+        auto fleet = TruckFleet(config.numTrucks, config.numStations, numSites);
+        phases.bytesPerTruck = bytesEach(config.numTrucks);
+        fleet.startTrucksAtMines();
+        phases.setupMs = elapsedMs(start);
+
+        start = Clock::now();
+        auto pacer = MinePacer(0);
+        fleet.run(pacer);
+        phases.runMs = elapsedMs(start);
+
+        start = Clock::now();
+        auto stats = MineCsvStatsSink(csvStamp);
+        fleet.outputStatistics(stats);
+        stats.close();
+        phases.outputMs = elapsedMs(start);
+        return phases;
+    }
+
+    auto overlord = MineOverlord();
+    auto trucks = instantiateTrucks(overlord, config.numTrucks);
+    phases.bytesPerTruck = bytesEach(config.numTrucks);
+    auto stations = instantiateStations(overlord, config.numStations);
+    phases.bytesPerStation = bytesEach(config.numStations);
+    auto sites = instantiateSites(overlord, numSites, 0);
+    phases.bytesPerSite = bytesEach(numSites);
+    startTrucksAtMines();
+    phases.setupMs = elapsedMs(start);
+
+    start = Clock::now();
+    auto options = MineOptions();
+    options.numTrucks = config.numTrucks;
+    options.numStations = config.numStations;
+    options.engine = config.engine;
+    options.realTimeFactor = 0;
+    overlord.run(options);
+    phases.runMs = elapsedMs(start);
+
+    start = Clock::now();
+    auto stats = MineCsvStatsSink(csvStamp);
+    overlord.outputStatistics(stats);
+    stats.close();
+    phases.outputMs = elapsedMs(start);
+    return phases;
+}
+
+/// Runs a simulation day in a process of its own, so that its peak resident set is its own, and
+/// its singletons start out empty; its log and CSV files are written to a directory of its own
+/// in outputDir, which is removed afterwards
+/// \throws std::runtime_error if the process cannot be started, or the simulation day fails
+ScaleResult measure(const ScaleConfig& config, const std::filesystem::path& outputDir) {
+    auto runDir = outputDir / ("acme-scale-" + std::to_string(getpid()));
+    std::filesystem::create_directories(runDir);
+
+    int channel[2];
+    if (pipe(channel) != 0) {
+        throw std::runtime_error("Cannot create a pipe");
+    }
+
+    auto start = Clock::now();
+    auto pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("Cannot fork");
+    }
+    if (pid == 0) {
+        // The child leaves with _exit, without running the parent's exit handlers
+        close(channel[0]);
+        auto status = EXIT_SUCCESS;
+        PhaseTimes phases;
+        try {
+            std::filesystem::current_path(runDir);
+            auto& logger = MineLogger::getInstance();
+            logger.setConsole(false);
+            for (std::size_t category = 0; category < NUM_LOG_CATEGORIES; ++category) {
+                logger.setLevel(static_cast<LogCategory>(category), LogLevel::OFF);
+            }
+            phases = runDay(config, "acme-scale");
+        } catch (const std::exception& exception) {
+            std::cerr << exception.what() << std::endl;
+            status = EXIT_FAILURE;
+        }
+        auto written = write(channel[1], &phases, sizeof(phases));
+        _exit(written == sizeof(phases) ? status : EXIT_FAILURE);
+    }
+
+    close(channel[1]);
+    ScaleResult result;
+    result.config = config;
+    auto received = read(channel[0], &result.phases, sizeof(result.phases));
+    close(channel[0]);
+
+    int status = 0;
+    rusage usage{};
+    wait4(pid, &status, 0, &usage);
+    result.wallMs = elapsedMs(start);
+    result.peakRssKiB = usage.ru_maxrss;
+
+    std::filesystem::remove_all(runDir);
+
+    if (received != sizeof(result.phases) || !WIFEXITED(status)
+        || WEXITSTATUS(status) != EXIT_SUCCESS) {
+        throw std::runtime_error(
+            std::string("Simulation day failed: ") + ENGINE_NAMES[static_cast<int>(config.engine)]
+            + " engine, " + std::to_string(config.numTrucks) + " trucks, "
+            + std::to_string(config.numStations) + " stations");
+    }
+    return result;
+}
+
+/// Prints the heading of the table printRow() fills in
+void printHeading() {
+    std::cout << std::left << std::setw(7) << "engine" << std::right << std::setw(10) << "trucks"
+              << std::setw(10) << "stations" << std::setw(11) << "wall ms" << std::setw(11)
+              << "setup ms" << std::setw(11) << "run ms" << std::setw(11) << "output ms"
+              << std::setw(15) << "ns/truck-tick" << std::setw(14) << "peak RSS KiB"
+              << std::setw(10) << "B/truck" << std::setw(11) << "B/station" << std::setw(9)
+              << "B/site" << std::endl;
+}
+
+///
+void printRow(const ScaleResult& result) {
+    const auto& phases = result.phases;
+    std::cout << std::fixed << std::setprecision(1) << std::left << std::setw(7)
+              << ENGINE_NAMES[static_cast<int>(result.config.engine)] << std::right
+              << std::setw(10) << result.config.numTrucks << std::setw(10)
+              << result.config.numStations << std::setw(11) << result.wallMs << std::setw(11)
+              << phases.setupMs << std::setw(11) << phases.runMs << std::setw(11)
+              << phases.outputMs << std::setw(15) << std::setprecision(2)
+              << result.getNsPerTruckTick() << std::setw(14) << result.peakRssKiB
+              << std::setprecision(0) << std::setw(10) << phases.bytesPerTruck << std::setw(11)
+              << phases.bytesPerStation << std::setw(9) << phases.bytesPerSite << std::endl;
+}
+
+/// Writes every measurement, one row per simulation day
+void writeReport(const std::string& path, const std::vector<ScaleResult>& results) {
+    std::ofstream output(path, std::ios::trunc);
+    output << "engine,trucks,stations,wallMs,setupMs,runMs,outputMs,nsPerTruckTick,peakRssKiB,"
+              "bytesPerTruck,bytesPerStation,bytesPerSite\n";
+    for (const auto& result : results) {
+        const auto& phases = result.phases;
+        output << ENGINE_NAMES[static_cast<int>(result.config.engine)] << ','
+               << result.config.numTrucks << ',' << result.config.numStations << ','
+               << result.wallMs << ',' << phases.setupMs << ',' << phases.runMs << ','
+               << phases.outputMs << ',' << result.getNsPerTruckTick() << ','
+               << result.peakRssKiB << ',' << phases.bytesPerTruck << ','
+               << phases.bytesPerStation << ',' << phases.bytesPerSite << '\n';
+    }
+}
+
+/// Writes the results as a baseline, with the default tolerances
+void writeBaseline(const std::string& path, const std::vector<ScaleResult>& results) {
+    std::ofstream output(path, std::ios::trunc);
+    output << "engine,trucks,stations,nsPerTruckTick,peakRssKiB,bytesPerTruck,timeTolerance,"
+              "memoryTolerance\n";
+    for (const auto& result : results) {
+        output << ENGINE_NAMES[static_cast<int>(result.config.engine)] << ','
+               << result.config.numTrucks << ',' << result.config.numStations << ','
+               << std::setprecision(3) << result.getNsPerTruckTick() << ','
+               << result.peakRssKiB << ',' << std::setprecision(0) << std::fixed
+               << result.phases.bytesPerTruck << std::defaultfloat << std::setprecision(3)
+               << ',' << DEFAULT_TIME_TOLERANCE << ',' << DEFAULT_MEMORY_TOLERANCE << '\n';
+    }
+}
+
+/// Reports a measurement that exceeds its baseline by more than the tolerance
+/// \return false if it does
+bool checkLimit(
+    const ScaleResult& result,
+    const char* what,
+    double measured,
+    double baseline,
+    double tolerance) {
+    auto limit = baseline * (1 + tolerance);
+    if (measured <= limit) {
+        return true;
+    }
+    std::cerr << "FAILED " << ENGINE_NAMES[static_cast<int>(result.config.engine)] << ' '
+              << result.config.numTrucks << " trucks, " << result.config.numStations
+              << " stations: " << what << ' ' << measured << " exceeds the baseline " << baseline
+              << " by more than " << tolerance * 100 << "%" << std::endl;
+    return false;
+}
+}  // namespace
+
+///
+int main(int argc, char** argv) {
+    std::vector<SimEngine> engines{SimEngine::FLEET};
+    std::vector<int> truckCounts{1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+    std::vector<int> stationCounts{10, 1000};
+    auto outputDir = std::filesystem::temp_directory_path();
+    std::string reportPath;
+    std::string baselinePath;
+    std::string writeBaselinePath;
+
+    try {
+        for (auto arg = 1; arg < argc; ++arg) {
+            std::string option(argv[arg]);
+            auto value = option.substr(option.find('=') + 1);
+            if (option.rfind("--engines=", 0) == 0) {
+                engines.clear();
+                for (const auto& name : split(value)) {
+                    engines.push_back(parseEngine(name));
+                }
+            } else if (option.rfind("--trucks=", 0) == 0) {
+                truckCounts = parseCounts(value);
+            } else if (option.rfind("--stations=", 0) == 0) {
+                stationCounts = parseCounts(value);
+            } else if (option.rfind("--output-dir=", 0) == 0) {
+                outputDir = value;
+            } else if (option.rfind("--report=", 0) == 0) {
+                reportPath = value;
+            } else if (option.rfind("--baseline=", 0) == 0) {
+                baselinePath = value;
+            } else if (option.rfind("--write-baseline=", 0) == 0) {
+                writeBaselinePath = value;
+            } else {
+                std::cerr << scaleUsageMessage() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        // A baseline brings its own grid
+        std::vector<Baseline> baseline;
+        std::vector<ScaleConfig> grid;
+        if (!baselinePath.empty()) {
+            baseline = readBaseline(baselinePath);
+            for (const auto& row : baseline) {
+                grid.push_back(row.config);
+            }
+        } else {
+            for (auto engine : engines) {
+                for (auto numTrucks : truckCounts) {
+                    for (auto numStations : stationCounts) {
+                        grid.push_back({engine, numTrucks, numStations});
+                    }
+                }
+            }
+        }
+
+        printHeading();
+        std::vector<ScaleResult> results;
+        for (const auto& config : grid) {
+            if (config.numTrucks <= 0 || config.numStations <= 0) {
+                throw std::invalid_argument("Every grid point needs trucks and stations");
+            }
+            results.push_back(measure(config, outputDir));
+            printRow(results.back());
+        }
+
+        if (!reportPath.empty()) {
+            writeReport(reportPath, results);
+        }
+        if (!writeBaselinePath.empty()) {
+            writeBaseline(writeBaselinePath, results);
+        }
+
+        auto passed = true;
+        for (std::size_t row = 0; row < baseline.size(); ++row) {
+            const auto& result = results[row];
+            const auto& limits = baseline[row];
+            passed &= checkLimit(
+                result,
+                "ns/truck-tick",
+                result.getNsPerTruckTick(),
+                limits.nsPerTruckTick,
+                limits.timeTolerance);
+            passed &= checkLimit(
+                result,
+                "peak RSS KiB",
+                static_cast<double>(result.peakRssKiB),
+                static_cast<double>(limits.peakRssKiB),
+                limits.memoryTolerance);
+            passed &= checkLimit(
+                result,
+                "bytes/truck",
+                result.phases.bytesPerTruck,
+                limits.bytesPerTruck,
+                limits.memoryTolerance);
+        }
+        if (!baseline.empty()) {
+            std::cout << (passed ? "Within" : "NOT within") << " the baseline " << baselinePath
+                      << std::endl;
+        }
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (const std::exception& exception) {
+        std::cerr << exception.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,342 @@
+/// \file   MineAllocCounter.cpp
+/// \brief  MineAllocCounter, and the replacement global operator new and operator delete
+#include "MineAllocCounter.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <new>
+
+#ifdef __linux__
+#include <cxxabi.h>
+#include <execinfo.h>
+#endif
+
+namespace acme {
+namespace {
+/// Frames kept of each call stack; enough to get past the standard library's allocator layers
+constexpr int MAX_FRAMES = 16;
+
+/// Distinct call stacks kept; allocations from any more are counted, but not placed
+constexpr std::size_t MAX_STACKS = 1024;
+
+/// A distinct call stack, and the allocations made from it
+struct CallStack {
+    std::array<void*, MAX_FRAMES> frames;
+    int depth;
+    std::uint64_t count;
+    std::uint64_t bytes;
+};
+
+// All constant-initialised, as operator new is called before main
+std::atomic<bool> counting{false};
+std::atomic<std::uint64_t> totalCount{0};
+std::atomic<std::uint64_t> totalBytes{0};
+std::atomic_flag stacksLock = ATOMIC_FLAG_INIT;
+std::array<CallStack, MAX_STACKS> stacks{};
+std::size_t numStacks = 0;
+
+/// Set while this thread is inside the counter, so that its own allocations, and those backtrace
+/// makes, are not counted
+thread_local bool inCounter = false;
+
+/// Keeps the calling thread's allocations out of the counts for its lifetime
+class PauseCounting {
+public:
+    PauseCounting()
+        : _wasInCounter(inCounter) {
+        inCounter = true;
+    }
+
+    ~PauseCounting() {
+        inCounter = _wasInCounter;
+    }
+
+private:
+    bool _wasInCounter;
+};
+
+/// Spins, as the lock is only held to look up a call stack
+void lockStacks() {
+    while (stacksLock.test_and_set(std::memory_order_acquire)) {
+    }
+}
+
+/// Counts an allocation, and the call stack it was made from
+/// \param bytes
+void countAllocation(std::size_t bytes) {
+    if (!counting.load(std::memory_order_relaxed) || inCounter) {
+        return;
+    }
+    auto pause = PauseCounting();
+    totalCount.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    CallStack callStack{};
+#ifdef __linux__
+    callStack.depth = backtrace(callStack.frames.data(), MAX_FRAMES);
+#endif
+
+    lockStacks();
+    auto last = stacks.begin() + numStacks;
+    auto found = std::find_if(stacks.begin(), last, [&callStack](const CallStack& stack) {
+        return stack.depth == callStack.depth && stack.frames == callStack.frames;
+    });
+    if (found == last && numStacks < MAX_STACKS) {
+        *found = callStack;
+        ++numStacks;
+    }
+    if (found != stacks.end()) {
+        ++found->count;
+        found->bytes += bytes;
+    }
+    stacksLock.clear(std::memory_order_release);
+}
+
+/// Names the innermost frame that is neither operator new nor in the standard library; frames
+/// without an exported symbol are named by their address
+/// \param callStack
+std::string nameCallSite(const CallStack& callStack) {
+    std::string callSite = "(unknown)";
+#ifdef __linux__
+    auto* symbols = backtrace_symbols(callStack.frames.data(), callStack.depth);
+    if (!symbols) {
+        return callSite;
+    }
+
+    // Each symbol reads "file(mangled+offset) [address]", or "file(+offset) [address]"
+    std::vector<std::string> functions;
+    auto callerFrame = 0;
+    for (auto frame = 0; frame < callStack.depth; ++frame) {
+        std::string symbol = symbols[frame];
+        auto open = symbol.find('(');
+        auto plus = symbol.find('+', open);
+        auto mangled = open < plus && plus != std::string::npos
+                           ? symbol.substr(open + 1, plus - open - 1)
+                           : std::string();
+        auto status = -1;
+        auto* demangled = mangled.empty()
+                              ? nullptr
+                              : abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+        functions.push_back(status == 0 ? demangled : mangled.empty() ? symbol : mangled);
+        std::free(demangled);
+        if (functions.back().find("operator new") != std::string::npos) {
+            callerFrame = frame + 1;
+        }
+    }
+    std::free(symbols);
+
+    for (auto frame = callerFrame; frame < callStack.depth; ++frame) {
+        const auto& function = functions[frame];
+        auto name = function.substr(0, function.find('('));
+        if (name.find("std::") == std::string::npos
+            && name.find("__gnu_cxx::") == std::string::npos) {
+            callSite = function;
+            break;
+        }
+    }
+#endif
+    return callSite;
+}
+
+/// Counts an allocation, then makes it
+/// \param size
+void* allocate(std::size_t size) {
+    countAllocation(size);
+    return std::malloc(size != 0 ? size : 1);
+}
+
+/// Counts an over-aligned allocation, then makes it; its size is rounded up to the alignment, as
+/// aligned_alloc requires
+/// \param size
+/// \param alignment
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    countAllocation(size);
+    auto align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    return std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align);
+}
+}  // namespace
+
+///
+std::uint64_t MineAllocCounter::getBytes() const {
+    return totalBytes.load(std::memory_order_relaxed);
+}
+
+///
+std::uint64_t MineAllocCounter::getCount() const {
+    return totalCount.load(std::memory_order_relaxed);
+}
+
+/// Merges the call stacks that share a call site; allocations beyond MAX_STACKS distinct call
+/// stacks are listed as one more site
+std::vector<MineAllocSite> MineAllocCounter::getSites() const {
+    auto pause = PauseCounting();
+    lockStacks();
+    std::vector<CallStack> callStacks(stacks.begin(), stacks.begin() + numStacks);
+    stacksLock.clear(std::memory_order_release);
+
+    std::map<std::string, MineAllocSite> bySite;
+    auto placedCount = std::uint64_t{0};
+    auto placedBytes = std::uint64_t{0};
+    for (const auto& callStack : callStacks) {
+        auto callSite = nameCallSite(callStack);
+        auto& site = bySite.try_emplace(callSite, MineAllocSite{callSite, 0, 0}).first->second;
+        site.count += callStack.count;
+        site.bytes += callStack.bytes;
+        placedCount += callStack.count;
+        placedBytes += callStack.bytes;
+    }
+
+    std::vector<MineAllocSite> sites;
+    for (auto& [callSite, site] : bySite) {
+        sites.push_back(std::move(site));
+    }
+    if (getCount() > placedCount) {
+        sites.push_back({"(more call sites)", getCount() - placedCount, getBytes() - placedBytes});
+    }
+    std::stable_sort(sites.begin(), sites.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.count > rhs.count;
+    });
+    return sites;
+}
+
+/// Writes a summary line, then one line per call site
+/// \param output
+/// \param numTicks
+void MineAllocCounter::report(std::ostream& output, int numTicks) const {
+    auto pause = PauseCounting();
+    auto perTick = [numTicks](std::uint64_t count) {
+        return numTicks != 0 ? static_cast<double>(count) / numTicks : 0.0;
+    };
+
+    output << std::fixed << std::setprecision(3) << "Heap allocations: " << getCount() << " in "
+           << numTicks << " ticks (" << perTick(getCount()) << " per tick), " << getBytes()
+           << " bytes\n";
+    for (const auto& site : getSites()) {
+        output << std::setw(10) << site.count << std::setw(12) << perTick(site.count)
+               << std::setw(12) << site.bytes << "  " << site.function << '\n';
+    }
+}
+
+///
+void MineAllocCounter::reset() {
+    lockStacks();
+    numStacks = 0;
+    totalCount.store(0, std::memory_order_relaxed);
+    totalBytes.store(0, std::memory_order_relaxed);
+    stacksLock.clear(std::memory_order_release);
+}
+
+/// Walks the stack once beforehand, as backtrace allocates the first time it is called
+void MineAllocCounter::start() {
+#ifdef __linux__
+    {
+        auto pause = PauseCounting();
+        std::array<void*, 1> frame{};
+        backtrace(frame.data(), 1);
+    }
+#endif
+    counting.store(true, std::memory_order_relaxed);
+}
+
+///
+void MineAllocCounter::stop() {
+    counting.store(false, std::memory_order_relaxed);
+}
+}  // namespace acme
+
+/// Replacement global allocation functions; they allocate with malloc, so every form of operator
+/// delete frees with free
+void* operator new(std::size_t size) {
+    if (auto* memory = acme::allocate(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+///
+void* operator new[](std::size_t size) {
+    if (auto* memory = acme::allocate(size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+///
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return acme::allocate(size);
+}
+
+///
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return acme::allocate(size);
+}
+
+///
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    if (auto* memory = acme::allocateAligned(size, alignment)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+///
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    if (auto* memory = acme::allocateAligned(size, alignment)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+///
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return acme::allocateAligned(size, alignment);
+}
+
+///
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return acme::allocateAligned(size, alignment);
+}
+
+///
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+///
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+///
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+///
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+///
+void operator delete(void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+///
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+///
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
+
+///
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+    std::free(memory);
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+/// \file   MineAllocCounter.h
+/// \brief  Counts heap allocations by call site, through a replacement global operator new
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace acme {
+/// \struct MineAllocSite
+/// \brief  The allocations counted at one call site
+struct MineAllocSite {
+    std::string function;  // Innermost caller outside the standard library
+    std::uint64_t count;
+    std::uint64_t bytes;
+};
+
+/// \class  MineAllocCounter
+/// \brief  Counts every operator new call, on any thread, between start() and stop(), and the
+///         call stack it came from
+/// \note   The replacement operator new is defined in MineAllocCounter.cpp, which is only linked
+///         into the unit tests and the benchmarks, so acme-mining itself allocates as usual. Call
+///         sites are named from the executable's exported symbols, so targets that link it are
+///         built with ENABLE_EXPORTS; a call site that cannot be named is shown as its address
+class MineAllocCounter {
+public:
+    ///
+    static MineAllocCounter& getInstance() {
+        static MineAllocCounter instance;
+        return instance;
+    }
+
+    MineAllocCounter(const MineAllocCounter&) = delete;
+    MineAllocCounter& operator=(const MineAllocCounter&) = delete;
+
+    /// Returns the bytes allocated while counting, since the last reset
+    std::uint64_t getBytes() const;
+
+    /// Returns the allocations counted since the last reset
+    std::uint64_t getCount() const;
+
+    /// Returns the allocations counted at each call site, most frequent first
+    std::vector<MineAllocSite> getSites() const;
+
+    /// Writes the allocations per tick at each call site, over numTicks ticks
+    void report(std::ostream& output, int numTicks) const;
+
+    /// Clears every count and call site
+    void reset();
+
+    ///
+    void start();
+
+    ///
+    void stop();
+
+private:
+    MineAllocCounter() = default;
+    ~MineAllocCounter() = default;
+};
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,184 @@
+/// \file   MineBranches.cpp
+#include "MineBranches.h"
+
+#include "MineLogger.h"
+#include "MinePacer.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace acme {
+namespace {
+/// Applies a branch's changes, runs the rest of the day and sends back its FleetSummary; never
+/// returns, as a child must not run the exit handlers and destructors of the parent's objects
+/// \param fleet
+/// \param pacer
+/// \param whatIf
+/// \param output   write end of the branch's pipe
+[[noreturn]] void runBranch(
+    TruckFleet& fleet,
+    MinePacer& pacer,
+    const MineWhatIf& whatIf,
+    int output) {
+    fleet.addStations(whatIf.addedStations);
+    fleet.withdrawTrucks(whatIf.removedTrucks);
+    if (whatIf.transitTime > 0) {
+        fleet.setTransitTime(whatIf.transitTime);
+    }
+    fleet.run(pacer);
+
+    auto summary = fleet.getSummary();
+    const auto* bytes = reinterpret_cast<const char*>(&summary);
+    std::size_t written = 0;
+    while (written < sizeof(summary)) {
+        auto result = ::write(output, bytes + written, sizeof(summary) - written);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            ::_exit(EXIT_FAILURE);
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    ::_exit(EXIT_SUCCESS);
+}
+
+/// Reads a branch's FleetSummary from its pipe
+/// \param input     read end of the branch's pipe
+/// \param summary
+/// \return false if the branch ended without sending all of it
+bool readSummary(int input, FleetSummary& summary) {
+    auto* bytes = reinterpret_cast<char*>(&summary);
+    std::size_t read = 0;
+    while (read < sizeof(summary)) {
+        auto result = ::read(input, bytes + read, sizeof(summary) - read);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        read += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+}  // namespace
+
+/// Constructor
+/// \param whatIfs
+MineBranches::MineBranches(const std::vector<MineWhatIf>& whatIfs) {
+    _whatIfs.push_back({"unchanged"});
+    _whatIfs.insert(_whatIfs.end(), whatIfs.begin(), whatIfs.end());
+}
+
+///
+const std::vector<FleetSummary>& MineBranches::getSummaries() const {
+    return _summaries;
+}
+
+/// Writes one row per branch:
+/// Branch,Trucks,Stations,Deliveries,DeliveriesChange,MeanQueueWait,StationUtilization,
+/// SiteUtilization
+/// with the branch's changes quoted, as they are separated by commas, the queue wait in minutes
+/// per delivery, and the utilizations as fractions of the time the stations and sites were in the
+/// day
+/// \param timestamp
+void MineBranches::outputReport(const std::string& timestamp) const {
+    std::ofstream output(timestamp + "_Branches" + ".csv", std::ios::trunc);
+    output << "Branch,Trucks,Stations,Deliveries,DeliveriesChange,MeanQueueWait,"
+              "StationUtilization,SiteUtilization"
+           << '\n';
+    output << std::fixed << std::setprecision(3);
+    auto& logger = MineLogger::getInstance();
+    for (std::size_t branch = 0; branch < _summaries.size(); ++branch) {
+        const auto& summary = _summaries[branch];
+        auto deliveriesChange = summary.deliveries - _summaries.front().deliveries;
+        auto queueWait = summary.getMeanQueueWait();
+        auto stationUtilization = summary.getStationUtilization();
+        auto siteUtilization = summary.getSiteUtilization();
+        output << '"' << _whatIfs[branch].label << "\"," << summary.numTrucks << ","
+               << summary.numStations << "," << summary.deliveries << "," << deliveriesChange
+               << "," << queueWait << "," << stationUtilization << "," << siteUtilization << '\n';
+
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << "Branch " << _whatIfs[branch].label << ": "
+            << summary.numTrucks << " trucks, " << summary.numStations << " stations, "
+            << summary.deliveries << " deliveries (" << std::showpos << deliveriesChange
+            << std::noshowpos << "), " << queueWait << " minutes queued per delivery, stations "
+            << (stationUtilization * 100) << "% and sites " << (siteUtilization * 100)
+            << "% utilized";
+        logger.logMessage(oss.str());
+    }
+}
+
+/// Forks one child per branch, then collects their summaries in branch order; a child that fails
+/// does not stop the others, but is reported once all of them have finished
+/// \param fleet   run up to the branch tick, on the calling thread only
+/// \param pacer
+/// \throws std::runtime_error if a branch cannot be started, or does not report back
+void MineBranches::run(TruckFleet& fleet, MinePacer& pacer) {
+    std::ostringstream oss;
+    oss << "Forking " << _whatIfs.size() << " branches at tick " << fleet.getNextTick();
+    auto& logger = MineLogger::getInstance();
+    logger.logMessage(oss.str());
+
+    struct Child {
+        pid_t pid;
+        int input;
+    };
+    std::vector<Child> children;
+    std::string failure;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& whatIf : _whatIfs) {
+        int pipeEnds[2];
+        if (::pipe(pipeEnds) != 0) {
+            failure = "Cannot create a pipe for branch " + whatIf.label;
+            break;
+        }
+        auto pid = ::fork();
+        if (pid < 0) {
+            ::close(pipeEnds[0]);
+            ::close(pipeEnds[1]);
+            failure = "Cannot fork branch " + whatIf.label;
+            break;
+        }
+        if (pid == 0) {
+            ::close(pipeEnds[0]);
+            runBranch(fleet, pacer, whatIf, pipeEnds[1]);
+        }
+        ::close(pipeEnds[1]);
+        children.push_back({pid, pipeEnds[0]});
+    }
+
+    _summaries.assign(children.size(), FleetSummary{});
+    for (std::size_t branch = 0; branch < children.size(); ++branch) {
+        auto reported = readSummary(children[branch].input, _summaries[branch]);
+        ::close(children[branch].input);
+        auto status = 0;
+        while (::waitpid(children[branch].pid, &status, 0) < 0 && errno == EINTR) {
+        }
+        auto succeeded = reported && WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+        if (!succeeded && failure.empty()) {
+            failure = "Branch " + _whatIfs[branch].label + " did not report back";
+        }
+    }
+    if (!failure.empty()) {
+        throw std::runtime_error(failure);
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    oss.str("");
+    oss << std::fixed << std::setprecision(3) << "Ran " << _whatIfs.size() << " branches in "
+        << elapsed.count() << " s";
+    logger.logMessage(oss.str());
+}
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,51 @@
+/// \file   MineBranches.h
+/// \brief  What-if branches of one simulation day, forked from it at a branch tick
+#pragma once
+#include "TruckFleet.h"
+
+#include <string>
+#include <vector>
+
+namespace acme {
+class MinePacer;
+
+/// \struct MineWhatIf
+/// \brief  The parameter changes a branch makes to the day, at the branch tick
+struct MineWhatIf {
+    std::string label;     // As given on the command line
+    int addedStations{0};
+    int removedTrucks{0};  // Highest-numbered first
+    int transitTime{0};    // In ticks, for the trips that start from then on; 0 if not changed
+};
+
+/// \class  MineBranches
+/// \brief  Runs the rest of a TruckFleet day once unchanged, and once per MineWhatIf, side by side,
+///         and compares the results
+/// \note   Each branch is a child process forked at the branch tick, so it starts from a
+///         copy-on-write copy of the whole day so far, and the shared prefix is only run once.
+///         The fleet must run on the calling thread only, as a child has no other threads; the
+///         children neither log nor write files, and send their FleetSummary back through a pipe
+class MineBranches {
+public:
+    /// Constructor; the first branch is always the unchanged day
+    explicit MineBranches(const std::vector<MineWhatIf>& whatIfs);
+
+    MineBranches() = delete;
+    MineBranches(const MineBranches&) = delete;
+    MineBranches& operator=(const MineBranches&) = delete;
+
+    /// Returns the summary of each branch's day, the unchanged one first
+    const std::vector<FleetSummary>& getSummaries() const;
+
+    /// Writes one row per branch, with its change in deliveries from the unchanged day
+    void outputReport(const std::string& timestamp) const;
+
+    /// Forks every branch from the fleet's next tick, then waits for all of them to finish
+    /// \throws std::runtime_error if a branch cannot be started, or does not report back
+    void run(TruckFleet& fleet, MinePacer& pacer);
+
+private:
+    std::vector<MineWhatIf> _whatIfs;
+    std::vector<FleetSummary> _summaries;
+};
+}  // namespace acme
\ No newline at end of file
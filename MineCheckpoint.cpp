@@ -0,0 +1,78 @@
+/// \file   MineCheckpoint.cpp
+#include "MineCheckpoint.h"
+
+#include "MineDefs.h"
+
+namespace acme {
+/// Creates the checkpoint file and writes its header
+/// \param fileName
+/// \param header
+/// \throws std::runtime_error if the file cannot be created
+MineCheckpointWriter::MineCheckpointWriter(
+    const std::string& fileName,
+    const CheckpointHeader& header)
+    : _fileName(fileName)
+    , _output(fileName, std::ios::binary | std::ios::trunc) {
+    if (!_output) {
+        throw std::runtime_error("Cannot create " + fileName);
+    }
+    _output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+///
+void MineCheckpointWriter::close() {
+    _output.close();
+    if (!_output) {
+        throw std::runtime_error("Cannot write " + _fileName);
+    }
+}
+
+/// Opens the checkpoint file and checks its header against this build
+/// \param fileName
+/// \throws std::runtime_error if the file cannot be opened, or is not a checkpoint of this
+///         version and day length
+MineCheckpointReader::MineCheckpointReader(const std::string& fileName)
+    : _fileName(fileName)
+    , _input(fileName, std::ios::binary | std::ios::ate) {
+    if (!_input) {
+        throw std::runtime_error("Cannot open " + fileName);
+    }
+    _remaining = static_cast<std::uint64_t>(_input.tellg());
+    _input.seekg(0);
+
+    if (_remaining < sizeof(CheckpointHeader)) {
+        throw std::runtime_error(fileName + " is not a checkpoint");
+    }
+    readBytes(&_header, sizeof(CheckpointHeader));
+    if (_header.magic != CHECKPOINT_MAGIC || _header.version != CHECKPOINT_VERSION) {
+        throw std::runtime_error(fileName + " is not a version "
+                                 + std::to_string(CHECKPOINT_VERSION) + " checkpoint");
+    }
+    if (_header.ticksPerDay != TICKS_PER_DAY || _header.nextTick < 0
+        || _header.nextTick >= TICKS_PER_DAY) {
+        throw std::runtime_error(fileName + " was taken on a day of another length");
+    }
+}
+
+///
+const CheckpointHeader& MineCheckpointReader::getHeader() const {
+    return _header;
+}
+
+/// \param bytes
+/// \param size
+/// \throws std::runtime_error if the file ends early
+void MineCheckpointReader::readBytes(void* bytes, std::size_t size) {
+    if (size > _remaining || !_input.read(static_cast<char*>(bytes), size)) {
+        throw std::runtime_error(_fileName + " is truncated");
+    }
+    _remaining -= size;
+}
+
+/// Reads the length that precedes every array
+std::uint64_t MineCheckpointReader::readLength() {
+    std::uint64_t length = 0;
+    readBytes(&length, sizeof(length));
+    return length;
+}
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,123 @@
+/// \file   MineCheckpoint.h
+/// \brief  Binary snapshot of a simulation day, taken between two ticks
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace acme {
+/// \struct CheckpointHeader
+/// \brief  Start of every checkpoint file
+struct CheckpointHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t ticksPerDay;
+    std::uint32_t numTrucks;
+    std::uint32_t numStations;
+    std::uint32_t numSites;
+    std::int32_t nextTick;  // First tick still to run
+    std::uint64_t seed;
+};
+
+static_assert(sizeof(CheckpointHeader) == 40, "CheckpointHeader is written as is");
+
+constexpr std::array<char, 8> CHECKPOINT_MAGIC{'A', 'C', 'M', 'E', 'C', 'K', 'P', 'T'};
+constexpr std::uint32_t CHECKPOINT_VERSION = 3;
+
+/// Values are copied to and from the file byte for byte
+template <typename T>
+constexpr bool IS_CHECKPOINTABLE =
+    std::is_trivially_copy_constructible_v<T> && std::is_trivially_destructible_v<T>;
+
+/// \class  MineCheckpointWriter
+/// \brief  Writes a CheckpointHeader, then arrays of values, each preceded by its length
+/// \note   Values are written in the host's byte order and layout, so a checkpoint is resumed by
+///         the same build that wrote it
+class MineCheckpointWriter {
+public:
+    /// Constructor
+    /// \throws std::runtime_error if the file cannot be created
+    MineCheckpointWriter(const std::string& fileName, const CheckpointHeader& header);
+
+    MineCheckpointWriter() = delete;
+    MineCheckpointWriter(const MineCheckpointWriter&) = delete;
+    MineCheckpointWriter& operator=(const MineCheckpointWriter&) = delete;
+
+    /// Flushes the file
+    /// \throws std::runtime_error if any write failed
+    void close();
+
+    ///
+    template <typename T>
+    void write(const T* values, std::size_t count) {
+        static_assert(IS_CHECKPOINTABLE<T>, "Checkpointed values are copied as bytes");
+        auto length = static_cast<std::uint64_t>(count);
+        _output.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        _output.write(reinterpret_cast<const char*>(values), sizeof(T) * count);
+    }
+
+    ///
+    template <typename T>
+    void write(const std::vector<T>& values) {
+        write(values.data(), values.size());
+    }
+
+private:
+    std::string _fileName;
+    std::ofstream _output;
+};
+
+/// \class  MineCheckpointReader
+/// \brief  Reads back the arrays of a checkpoint, in the order they were written
+class MineCheckpointReader {
+public:
+    /// Constructor
+    /// \throws std::runtime_error if the file cannot be opened, or is not a checkpoint
+    explicit MineCheckpointReader(const std::string& fileName);
+
+    MineCheckpointReader() = delete;
+    MineCheckpointReader(const MineCheckpointReader&) = delete;
+    MineCheckpointReader& operator=(const MineCheckpointReader&) = delete;
+
+    ///
+    const CheckpointHeader& getHeader() const;
+
+    /// Reads the next array over count values that are already in place
+    /// \throws std::runtime_error if the array has a different length, or the file ends early
+    template <typename T>
+    void read(T* values, std::size_t count) {
+        static_assert(IS_CHECKPOINTABLE<T>, "Checkpointed values are copied as bytes");
+        if (readLength() != count) {
+            throw std::runtime_error(_fileName + " does not match the simulation it is read into");
+        }
+        readBytes(values, sizeof(T) * count);
+    }
+
+    /// Reads the next array, replacing the contents of values
+    /// \throws std::runtime_error if the file ends early
+    template <typename T>
+    void read(std::vector<T>& values) {
+        static_assert(IS_CHECKPOINTABLE<T>, "Checkpointed values are copied as bytes");
+        auto length = readLength();
+        if (length > _remaining / sizeof(T)) {
+            throw std::runtime_error(_fileName + " is truncated");
+        }
+        values.resize(length);
+        readBytes(values.data(), sizeof(T) * length);
+    }
+
+private:
+    void readBytes(void* bytes, std::size_t size);
+    std::uint64_t readLength();
+
+    std::string _fileName;
+    std::ifstream _input;
+    std::uint64_t _remaining{0};  // Bytes left to read
+    CheckpointHeader _header{};
+};
+}  // namespace acme
\ No newline at end of file
@@ -2,6 +2,9 @@
 #pragma once
 
 namespace acme {
+/// Simulation time, in ticks since the start of the mining day
+using SimTime = int;
+
 ///
 constexpr int MINING_DAY = 72;  // 72-hour mining day
 
@@ -10,6 +13,8 @@ constexpr int SECONDS_PER_TICK = TICK_DURATION * 60;
 constexpr int TICKS_PER_HOUR = 60 / TICK_DURATION;
 constexpr int TICKS_PER_DAY = (MINING_DAY * 60) / TICK_DURATION;
 
+constexpr double REAL_TIME_FACTOR = SECONDS_PER_TICK / 0.25;  // One tick every 0.25 s
+
 constexpr int TRUCK_TRANSIT_TIME = 30 / TICK_DURATION;   // 30 minute transit
 constexpr int TRUCK_UNLOADING_TIME = 5 / TICK_DURATION;  // 5 minute unloading time
 }  // namespace acme
\ No newline at end of file
@@ -1,32 +1,45 @@
 /// \file   MineDispatchers.cpp
 #include "MineDispatchers.h"
 
+#include "MineMetrics.h"
 #include "MineSite.h"
 
 namespace acme {
 /// Pushes a MineSite onto the (idle) queue
 /// \param mineSite
 void SiteDispatcher::enqueue(MineSite* mineSite) {
+    auto timer = MinePhaseTimer(MetricPhase::DISPATCH);
+    MineMetrics::getInstance().countDispatch(DispatchOp::SITE_ENQUEUE);
     _siteQueue.push(mineSite);
 }
 
 /// Gets an idle MineSite from the front of the queue
 MineSite* SiteDispatcher::getNextAvailableMine() {
-    auto* mineSite = _siteQueue.front();
-    _siteQueue.pop();
-    return mineSite;
+    auto timer = MinePhaseTimer(MetricPhase::DISPATCH);
+    MineMetrics::getInstance().countDispatch(DispatchOp::SITE_DEQUEUE);
+    return _siteQueue.pop();
 }
 
-/// Pushes a MineStation and resorts the priority queue
+/// Adds a new MineStation to the heap, or updates its queue size in place
 /// \param mineStation
 void StationDispatcher::enqueue(MineStation* mineStation) {
-    _stationQueue.push(mineStation);
+    auto timer = MinePhaseTimer(MetricPhase::DISPATCH);
+    MineMetrics::getInstance().countDispatch(DispatchOp::STATION_ENQUEUE);
+    auto queueSize = static_cast<std::int32_t>(mineStation->getQueueSize());
+    auto [entry, added] =
+        _stationIndex.try_emplace(mineStation, static_cast<std::int32_t>(_stations.size()));
+    if (added) {
+        _stations.push_back(mineStation);
+        _stationHeap.push(entry->second, queueSize);
+    } else {
+        _stationHeap.update(entry->second, queueSize);
+    }
 }
 
-/// Gets the MineStation with the shortest wait from the front of the queue
+/// Gets the MineStation with the shortest wait from the top of the heap
 MineStation* StationDispatcher::getNextAvailableStation() {
-    auto* mineStation = _stationQueue.top();
-    _stationQueue.pop();
-    return mineStation;
+    auto timer = MinePhaseTimer(MetricPhase::DISPATCH);
+    MineMetrics::getInstance().countDispatch(DispatchOp::STATION_SELECT);
+    return _stations[_stationHeap.top()];
 }
 }  // namespace acme
\ No newline at end of file
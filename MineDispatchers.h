@@ -1,12 +1,17 @@
 /// \file   MineDispatchers.cpp
 /// \brief  Dispatcher classes and their object registry
 #pragma once
+#include "MineIndexedHeap.h"
+#include "MineRingQueue.h"
 #include "MineStation.h"
 
+#include <cstdint>
 #include <memory>
-#include <queue>
+#include <unordered_map>
+#include <vector>
 
 namespace acme {
+class MineJournal;
 class MineSite;
 class MineTruck;
 ///
@@ -21,30 +26,26 @@ public:
     MineSite* getNextAvailableMine();
 
 private:
-    std::queue<MineSite*> _siteQueue;
+    MineRingQueue<MineSite*> _siteQueue;
 };
 
-/// Custom comparator for StationDispatcher; makes the priority_queue a min-heap
-class StationDispatcher;
-struct CompareQueueSize {
-    bool operator()(const MineStation* station1, const MineStation* station2) {
-        return station1->getQueueSize() > station2->getQueueSize();
-    }
-};
-
-///
+/// \class  StationDispatcher
+/// \brief  Keeps every MineStation once in an indexed min-heap on its queue size
+/// \note   Ties go to the MineStation enqueued first
 class StationDispatcher {
 public:
     StationDispatcher() = default;
 
-    ///
+    /// Adds a MineStation, or moves it to its new place after its queue has changed
     void enqueue(MineStation*);
 
-    ///
+    /// Returns the MineStation with the shortest queue, which stays in the dispatcher
     MineStation* getNextAvailableStation();
 
 private:
-    std::priority_queue<MineStation*, std::vector<MineStation*>, CompareQueueSize> _stationQueue;
+    MineIndexedHeap<> _stationHeap;
+    std::vector<MineStation*> _stations;  // By index in the heap, in the order they were enqueued
+    std::unordered_map<const MineStation*, std::int32_t> _stationIndex;
 };
 
 ///
@@ -69,6 +70,20 @@ public:
     MineRegistry(const MineRegistry&) = delete;
     MineRegistry& operator=(const MineRegistry&) = delete;
 
+    /// Discards all Dispatchers, the MineJournal and the MineStationWaker, e.g. between simulations
+    void reset() {
+        _siteDispatcher.reset();
+        _stationDispatcher.reset();
+        _truckDispatcher.reset();
+        _journal = nullptr;
+        _stationWaker = nullptr;
+    }
+
+    /// Returns the MineJournal that records transitions, or nullptr if there is none
+    MineJournal* getJournal() const {
+        return _journal;
+    }
+
     ///
     std::shared_ptr<SiteDispatcher> getSiteDispatcher() {
         if (!_siteDispatcher) {
@@ -85,6 +100,11 @@ public:
         return _stationDispatcher;
     }
 
+    /// Returns the MineStationWaker that wakes sleeping MineStations, or nullptr if there is none
+    MineStationWaker* getStationWaker() const {
+        return _stationWaker;
+    }
+
     ///
     std::shared_ptr<TruckDispatcher> getTruckDispatcher() {
         if (!_truckDispatcher) {
@@ -93,6 +113,16 @@ public:
         return _truckDispatcher;
     }
 
+    /// The caller keeps ownership of the MineJournal
+    void setJournal(MineJournal* journal) {
+        _journal = journal;
+    }
+
+    /// The caller keeps ownership of the MineStationWaker
+    void setStationWaker(MineStationWaker* stationWaker) {
+        _stationWaker = stationWaker;
+    }
+
 private:
     MineRegistry() = default;
     ~MineRegistry() = default;
@@ -100,5 +130,7 @@ private:
     std::shared_ptr<SiteDispatcher> _siteDispatcher;
     std::shared_ptr<StationDispatcher> _stationDispatcher;
     std::shared_ptr<TruckDispatcher> _truckDispatcher;
+    MineJournal* _journal{nullptr};
+    MineStationWaker* _stationWaker{nullptr};
 };
 }  // namespace acme
\ No newline at end of file
@@ -0,0 +1,182 @@
+/// \file   MineEventEngine.cpp
+#include "MineEventEngine.h"
+
+#include "MineDefs.h"
+#include "MineDispatchers.h"
+#include "MineLogger.h"
+#include "MineMetrics.h"
+#include "MinePacer.h"
+#include "MineSite.h"
+#include "MineStation.h"
+#include "MineTruck.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace acme {
+namespace {
+constexpr int PHASE_SHIFT = 32;
+constexpr std::uint64_t INDEX_MASK = (std::uint64_t{1} << PHASE_SHIFT) - 1;
+}  // namespace
+
+/// Sorts the MineMinions by kind, preserving the order in which they were attached, then schedules
+/// every MineTruck; startTrucksAtMines() has put each of them in MINING before the first tick
+/// \param minions
+/// \param fixedTick   paces every tick, and wakes the MineTrucks that log on every tick
+MineEventEngine::MineEventEngine(const std::vector<MineMinion*>& minions, bool fixedTick)
+    : _fixedTick(fixedTick) {
+    for (auto* minion : minions) {
+        if (auto* truck = dynamic_cast<MineTruck*>(minion)) {
+            _trucks.push_back(truck);
+        } else if (auto* station = dynamic_cast<MineStation*>(minion)) {
+            _stationIndex[station] = _stations.size();
+            _stations.push_back(station);
+        } else if (auto* site = dynamic_cast<MineSite*>(minion)) {
+            _sites.push_back(site);
+        }
+    }
+
+    // Everything has been accounted for up to the tick before the day begins
+    _truckSynced.assign(_trucks.size(), -1);
+    _stationSynced.assign(_stations.size(), -1);
+
+    // Each MineMinion is normally due, and wakes a MineStation, at most once per tick
+    auto numMinions = _trucks.size() + _stations.size();
+    _events.reserve(numMinions);
+    _due.reserve(numMinions);
+    _wokenStations.reserve(numMinions);
+    _stationsDue.reserve(numMinions);
+
+    MineRegistry::getInstance().setStationWaker(this);
+    for (std::size_t truck = 0; truck < _trucks.size(); ++truck) {
+        auto* mineTruck = _trucks[truck];
+        auto tick = isLogged(mineTruck) ? 0 : mineTruck->getRemainingDuration() - 1;
+        schedule(tick, TRUCK_PHASE, truck);
+    }
+}
+
+/// Stops waking sleeping MineStations
+MineEventEngine::~MineEventEngine() {
+    auto& registry = MineRegistry::getInstance();
+    if (registry.getStationWaker() == this) {
+        registry.setStationWaker(nullptr);
+    }
+}
+
+/// Accounts for the quiet ticks at the end of the day
+void MineEventEngine::finish() {
+    auto finishTimer = MinePhaseTimer(MetricPhase::TICK_UPDATE);
+    constexpr auto lastTick = TICKS_PER_DAY - 1;
+    for (std::size_t truck = 0; truck < _trucks.size(); ++truck) {
+        _trucks[truck]->advance(lastTick - _truckSynced[truck]);
+    }
+    for (std::size_t station = 0; station < _stations.size(); ++station) {
+        _stations[station]->advance(lastTick - _stationSynced[station]);
+    }
+    // MineSites are never updated until now; they accumulate their ticks when their flag changes
+    for (auto* site : _sites) {
+        site->update(lastTick);
+    }
+}
+
+/// True if the MineTruck is woken on every tick to log its progress
+/// \param mineTruck
+bool MineEventEngine::isLogged(const MineTruck* mineTruck) const {
+    if constexpr (static_cast<int>(LogLevel::INFO) <= ACME_LOG_CEILING) {
+        return _fixedTick
+               && MineLogger::getInstance().isEnabled(
+                   LogLevel::INFO, LogCategory::TRUCK, mineTruck->getId());
+    }
+    return false;
+}
+
+/// Runs through a simulation 'day' (72 hours), waking only the MineMinions due on each tick
+/// \param pacer   holds each paced tick to its wall-clock deadline
+void MineEventEngine::run(MinePacer& pacer) {
+    for (auto tick = _events.now(); tick < TICKS_PER_DAY; ++tick) {
+        this->tick(tick, pacer);
+    }
+    finish();
+}
+
+/// Places an event on the timing wheel
+/// \param tick
+/// \param phase
+/// \param index
+void MineEventEngine::schedule(int tick, Phase phase, std::size_t index) {
+    _events.schedule(tick, (static_cast<Event>(phase) << PHASE_SHIFT) | static_cast<Event>(index));
+}
+
+/// Wakes the MineMinions due on this tick; a tick without any is only paced with fixedTick
+/// \param now     the tick after the previous one
+/// \param pacer
+void MineEventEngine::tick(SimTime now, MinePacer& pacer) {
+    assert(now == _events.now());
+    _due.clear();
+    _events.collect(_due);
+    if (_due.empty() && !_fixedTick) {
+        return;
+    }
+    pacer.awaitTick(now);
+    auto tickTimer = MinePhaseTimer(MetricPhase::TICK_UPDATE);
+
+    // MineTrucks first, in attach order; they may wake MineStations for this tick
+    std::sort(_due.begin(), _due.end());
+    for (auto event : _due) {
+        auto index = static_cast<std::size_t>(event & INDEX_MASK);
+        if ((event >> PHASE_SHIFT) == TRUCK_PHASE) {
+            updateTruck(index, now);
+        } else {
+            _wokenStations.push_back(index);
+        }
+    }
+
+    // Several events may wake the same MineStation on one tick
+    _stationsDue.swap(_wokenStations);
+    std::sort(_stationsDue.begin(), _stationsDue.end());
+    _stationsDue.erase(std::unique(_stationsDue.begin(), _stationsDue.end()), _stationsDue.end());
+    for (auto station : _stationsDue) {
+        updateStation(station, now);
+    }
+    _stationsDue.clear();
+}
+
+/// Updates a MineStation that was woken, or whose unloading ends, on this tick
+/// \param index
+/// \param tick
+void MineEventEngine::updateStation(std::size_t index, int tick) {
+    // The MineStation accounts for the ticks it slept through itself
+    auto* station = _stations[index];
+    auto previousState = station->getState();
+    station->update(tick);
+    _stationSynced[index] = tick;
+
+    // A MineStation that finishes unloading with a MineTruck already waiting takes it on the next
+    // tick; otherwise it sleeps until it is woken
+    auto stationState = station->getState();
+    if (stationState == StationState::UNLOADING) {
+        schedule(tick + station->getRemainingDuration(), STATION_PHASE, index);
+    } else if (previousState != stationState && station->isTruckWaiting()) {
+        schedule(tick + 1, STATION_PHASE, index);
+    }
+}
+
+/// Updates a MineTruck whose current state expires on this tick, or that logs on every tick
+/// \param index
+/// \param tick
+void MineEventEngine::updateTruck(std::size_t index, int tick) {
+    auto* truck = _trucks[index];
+    truck->advance(tick - _truckSynced[index] - 1);
+
+    truck->update(tick);
+    _truckSynced[index] = tick;
+
+    schedule(isLogged(truck) ? tick + 1 : tick + truck->getRemainingDuration(), TRUCK_PHASE, index);
+}
+
+/// Has a MineStation updated in the station phase of this tick
+/// \param mineStation
+void MineEventEngine::wakeStation(MineStation& mineStation) {
+    _wokenStations.push_back(_stationIndex.at(&mineStation));
+}
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,76 @@
+/// \file   MineEventEngine.h
+/// \brief  Runs the simulation day by waking only the MineMinions whose state expires
+#pragma once
+#include "MineDefs.h"
+#include "MineStation.h"
+#include "MineTimingWheel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace acme {
+class MineMinion;
+class MinePacer;
+class MineSite;
+class MineTruck;
+
+/// \class  MineEventEngine
+/// \brief  Wakes the MineMinions whose state expires on a tick, from a MineTimingWheel, instead of
+///         visiting every MineMinion on every tick
+/// \note   MineMinions are only updated on the ticks where visiting all of them would change their
+///         state; the ticks in between are accounted for with MineMinion::advance, so the
+///         statistics are identical to those of updating every MineMinion on every tick.
+///         MineStations sleep until they are woken, as the MineStationWaker, or their unloading
+///         ends, and MineSites are only brought up to date at the end of the day. With fixedTick,
+///         every tick is paced, and the MineTrucks whose messages are enabled are also woken on
+///         every tick, to log their progress; otherwise only the ticks with state changes are
+///         paced, and only state changes are logged
+class MineEventEngine : public MineStationWaker {
+public:
+    /// Constructor; wakes sleeping MineStations, and schedules every MineTruck, from here on
+    MineEventEngine(const std::vector<MineMinion*>& minions, bool fixedTick);
+
+    MineEventEngine() = delete;
+    MineEventEngine(const MineEventEngine&) = delete;
+    MineEventEngine& operator=(const MineEventEngine&) = delete;
+
+    ///
+    ~MineEventEngine() override;
+
+    /// Runs through the rest of the day, then brings every MineMinion up to the last tick
+    void run(MinePacer& pacer);
+
+    /// Wakes the MineMinions due on the next tick of the day
+    void tick(SimTime now, MinePacer& pacer);
+
+    ///
+    void wakeStation(MineStation& mineStation) override;
+
+private:
+    /// Events due on a tick are handled MineTrucks before MineStations, then in attach order
+    using Event = std::uint64_t;
+    enum Phase : std::uint64_t { TRUCK_PHASE = 0, STATION_PHASE = 1 };
+
+    void finish();
+    bool isLogged(const MineTruck* mineTruck) const;
+    void schedule(int tick, Phase phase, std::size_t index);
+    void updateStation(std::size_t index, int tick);
+    void updateTruck(std::size_t index, int tick);
+
+    std::vector<MineTruck*> _trucks;
+    std::vector<MineStation*> _stations;
+    std::vector<MineSite*> _sites;
+
+    std::vector<int> _truckSynced;
+    std::vector<int> _stationSynced;
+    std::unordered_map<const MineStation*, std::size_t> _stationIndex;
+
+    MineTimingWheel<Event> _events;
+    std::vector<Event> _due;
+    std::vector<std::size_t> _wokenStations;
+    std::vector<std::size_t> _stationsDue;
+    bool _fixedTick;
+};
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,122 @@
+/// \file   MineIndexedHeap.h
+/// \brief  d-ary min-heap of dense item indices, whose keys can be changed in place
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace acme {
+/// \class  MineIndexedHeap
+/// \brief  Min-heap of items 0..N-1, each held at most once, ordered by key, then by item
+/// \note   Nodes carry their keys, so sifting only touches the node array, and Arity children share
+///         a cache line; the position of every item is tracked, so its key is changed in O(log N)
+template <std::size_t Arity = 4>
+class MineIndexedHeap {
+public:
+    static_assert(Arity >= 2, "A heap needs at least two children per node");
+
+    MineIndexedHeap() = default;
+
+    ///
+    bool contains(std::int32_t item) const {
+        return item >= 0 && static_cast<std::size_t>(item) < _positions.size()
+               && _positions[item] != ABSENT;
+    }
+
+    ///
+    bool empty() const {
+        return _nodes.empty();
+    }
+
+    /// Adds an item that is not in the heap yet
+    void push(std::int32_t item, std::int32_t key) {
+        assert(item >= 0 && !contains(item));
+        if (static_cast<std::size_t>(item) >= _positions.size()) {
+            _positions.resize(item + 1, ABSENT);
+        }
+        _nodes.push_back({key, item});
+        siftUp(_nodes.size() - 1);
+    }
+
+    ///
+    std::size_t size() const {
+        return _nodes.size();
+    }
+
+    /// Returns the item with the smallest key, and of those, the smallest item
+    std::int32_t top() const {
+        assert(!empty());
+        return _nodes.front().item;
+    }
+
+    /// Changes the key of an item in the heap, and moves it to its new place
+    void update(std::int32_t item, std::int32_t key) {
+        assert(contains(item));
+        auto position = static_cast<std::size_t>(_positions[item]);
+        auto oldKey = _nodes[position].key;
+        _nodes[position].key = key;
+        if (key < oldKey) {
+            siftUp(position);
+        } else if (key > oldKey) {
+            siftDown(position);
+        }
+    }
+
+private:
+    struct Node {
+        std::int32_t key;
+        std::int32_t item;
+
+        bool operator<(const Node& other) const {
+            return key < other.key || (key == other.key && item < other.item);
+        }
+    };
+
+    void place(std::size_t position, const Node& node) {
+        _nodes[position] = node;
+        _positions[node.item] = static_cast<std::int32_t>(position);
+    }
+
+    void siftDown(std::size_t position) {
+        auto node = _nodes[position];
+        for (;;) {
+            auto first = position * Arity + 1;
+            if (first >= _nodes.size()) {
+                break;
+            }
+            auto last = first + Arity < _nodes.size() ? first + Arity : _nodes.size();
+            auto smallest = first;
+            for (auto child = first + 1; child < last; ++child) {
+                if (_nodes[child] < _nodes[smallest]) {
+                    smallest = child;
+                }
+            }
+            if (!(_nodes[smallest] < node)) {
+                break;
+            }
+            place(position, _nodes[smallest]);
+            position = smallest;
+        }
+        place(position, node);
+    }
+
+    void siftUp(std::size_t position) {
+        auto node = _nodes[position];
+        while (position != 0) {
+            auto parent = (position - 1) / Arity;
+            if (!(node < _nodes[parent])) {
+                break;
+            }
+            place(position, _nodes[parent]);
+            position = parent;
+        }
+        place(position, node);
+    }
+
+    static constexpr std::int32_t ABSENT = -1;
+
+    std::vector<Node> _nodes;
+    std::vector<std::int32_t> _positions;  // Index of each item's node, or ABSENT
+};
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,313 @@
+/// \file   MineJournal.cpp
+#include "MineJournal.h"
+
+#include "MineStatsSink.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace acme {
+/// Creates the journal file and writes its header
+/// \param fileName
+/// \param numTrucks
+/// \param numStations
+/// \param numSites
+/// \param seed
+/// \throws std::runtime_error if the file cannot be created
+MineJournal::MineJournal(
+    const std::string& fileName,
+    int numTrucks,
+    int numStations,
+    int numSites,
+    std::uint64_t seed)
+    : _fileName(fileName)
+    , _output(fileName, std::ios::binary | std::ios::trunc) {
+    if (!_output) {
+        throw std::runtime_error("Cannot create " + fileName);
+    }
+
+    JournalHeader header{};
+    header.magic = JOURNAL_MAGIC;
+    header.version = JOURNAL_VERSION;
+    header.ticksPerDay = TICKS_PER_DAY;
+    header.numTrucks = numTrucks;
+    header.numStations = numStations;
+    header.numSites = numSites;
+    header.seed = seed;
+    _output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _buffer.reserve(BUFFER_RECORDS);
+}
+
+/// Writes out the records still in the buffer, unless the journal was closed; a failure can no
+/// longer be reported from here, so close() is the way to find out the journal is complete
+MineJournal::~MineJournal() {
+    if (_output.is_open()) {
+        writeBuffer();
+    }
+}
+
+/// Delta-encodes the tick and buffers the record
+void MineJournal::append(SimTime now, JournalKind kind, int value, int entity, int target) {
+    assert(now >= _lastTick && now - _lastTick <= std::numeric_limits<std::uint16_t>::max());
+    JournalRecord record{};
+    record.kind = kind;
+    record.value = static_cast<std::uint8_t>(value);
+    record.tickDelta = static_cast<std::uint16_t>(now - _lastTick);
+    record.entity = static_cast<std::uint32_t>(entity);
+    record.target = static_cast<std::uint32_t>(target);
+    _lastTick = now;
+
+    _buffer.push_back(record);
+    if (_buffer.size() == BUFFER_RECORDS) {
+        flush();
+    }
+}
+
+/// Writes out the records still in the buffer, and closes the file
+/// \throws std::runtime_error if the journal could not be written in full
+void MineJournal::close() {
+    auto written = writeBuffer();
+    _output.close();
+    if (!written || !_output) {
+        throw std::runtime_error("Cannot write " + _fileName);
+    }
+}
+
+///
+/// \param now
+/// \param truck
+/// \param site
+void MineJournal::dispatchToSite(SimTime now, int truck, int site) {
+    append(now, JournalKind::SITE_DISPATCH, 0, truck, site);
+}
+
+/// Records a truck joining a station queue; places beyond 255 are saturated
+/// \param now
+/// \param truck
+/// \param station
+/// \param placeInQueue
+void MineJournal::dispatchToStation(SimTime now, int truck, int station, int placeInQueue) {
+    append(now, JournalKind::STATION_DISPATCH, std::min(placeInQueue, 255), truck, station);
+}
+
+///
+/// \param now
+/// \param truck
+/// \param truckState
+void MineJournal::enterState(SimTime now, int truck, TruckState truckState) {
+    append(now, JournalKind::TRUCK_STATE, static_cast<int>(truckState), truck, 0);
+}
+
+///
+/// \param now
+/// \param station
+/// \param stationState
+void MineJournal::enterState(SimTime now, int station, StationState stationState) {
+    append(now, JournalKind::STATION_STATE, static_cast<int>(stationState), station, 0);
+}
+
+/// Appends the buffered records to the file
+/// \throws std::runtime_error if they cannot be written
+void MineJournal::flush() {
+    if (!writeBuffer()) {
+        throw std::runtime_error("Cannot write " + _fileName);
+    }
+}
+
+/// \return false if the buffered records, or any written before them, could not be written
+bool MineJournal::writeBuffer() {
+    _output.write(
+        reinterpret_cast<const char*>(_buffer.data()),
+        static_cast<std::streamsize>(_buffer.size() * sizeof(JournalRecord)));
+    _output.flush();
+    _buffer.clear();
+    return static_cast<bool>(_output);
+}
+
+/// Maps the whole file read-only and checks its header
+/// \param fileName
+MineJournalReader::MineJournalReader(const std::string& fileName) {
+    auto descriptor = ::open(fileName.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Cannot open " + fileName);
+    }
+
+    struct stat status {};
+    if (::fstat(descriptor, &status) == 0) {
+        _size = static_cast<std::size_t>(status.st_size);
+    }
+    if (_size >= sizeof(JournalHeader)) {
+        _mapping = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    }
+    ::close(descriptor);
+
+    if (_mapping == nullptr || _mapping == MAP_FAILED) {
+        _mapping = nullptr;
+        throw std::runtime_error("Cannot map " + fileName);
+    }
+    ::madvise(_mapping, _size, MADV_SEQUENTIAL);
+
+    std::memcpy(&_header, _mapping, sizeof(JournalHeader));
+    if (_header.magic != JOURNAL_MAGIC || _header.version != JOURNAL_VERSION) {
+        ::munmap(_mapping, _size);
+        throw std::runtime_error(fileName + " is not a version " + std::to_string(JOURNAL_VERSION)
+                                 + " journal");
+    }
+    _numRecords = (_size - sizeof(JournalHeader)) / sizeof(JournalRecord);
+}
+
+///
+MineJournalReader::~MineJournalReader() {
+    ::munmap(_mapping, _size);
+}
+
+///
+const JournalHeader& MineJournalReader::getHeader() const {
+    return _header;
+}
+
+///
+std::size_t MineJournalReader::getNumRecords() const {
+    return _numRecords;
+}
+
+/// Replays every transition, accumulating the time in each state from entry and exit ticks
+/// \param reader
+/// \throws std::runtime_error if a record refers to an entity or state the header and this build
+///         do not declare
+MineJournalReplay::MineJournalReplay(const MineJournalReader& reader) {
+    const auto& header = reader.getHeader();
+    _truckTime.assign(header.numTrucks, {});
+    _stationTime.assign(header.numStations, {});
+    _siteIdleTime.assign(header.numSites, 0);
+    _siteMiningTime.assign(header.numSites, 0);
+    _siteMining.assign(header.numSites, 0);
+    _siteChanged.assign(header.numSites, 0);
+
+    // Everything starts, as in TruckFleet, on the tick before the day begins
+    std::vector<TruckState> truckState(header.numTrucks, TruckState::MINING);
+    std::vector<SimTime> truckEntered(header.numTrucks, -1);
+    std::vector<std::uint32_t> truckSite(header.numTrucks, 0);
+    std::vector<StationState> stationState(header.numStations, StationState::IDLE);
+    std::vector<SimTime> stationEntered(header.numStations, -1);
+
+    auto check = [](std::uint32_t id, std::size_t count) {
+        if (id >= count) {
+            throw std::runtime_error("Journal record out of range");
+        }
+    };
+
+    reader.forEach([&](SimTime tick, const JournalRecord& record) {
+        switch (record.kind) {
+        case JournalKind::TRUCK_STATE: {
+            auto truck = record.entity;
+            check(truck, header.numTrucks);
+            check(record.value, NUM_TRUCK_STATES);
+            _truckTime[truck][index(truckState[truck])] += tick - truckEntered[truck];
+            truckEntered[truck] = tick;
+            truckState[truck] = static_cast<TruckState>(record.value);
+
+            // Sites change their flag when a truck starts or stops mining them
+            if (truckState[truck] == TruckState::MINING) {
+                setMiningFlag(truckSite[truck], true, std::max(tick, 0));
+            } else if (truckState[truck] == TruckState::INBOUND) {
+                setMiningFlag(truckSite[truck], false, tick);
+            }
+            break;
+        }
+        case JournalKind::STATION_STATE: {
+            auto station = record.entity;
+            check(station, header.numStations);
+            check(record.value, NUM_STATION_STATES);
+            _stationTime[station][index(stationState[station])] += tick - stationEntered[station];
+            stationEntered[station] = tick;
+            stationState[station] = static_cast<StationState>(record.value);
+            break;
+        }
+        case JournalKind::SITE_DISPATCH:
+            check(record.entity, header.numTrucks);
+            check(record.target, header.numSites);
+            truckSite[record.entity] = record.target;
+            break;
+        case JournalKind::STATION_DISPATCH:
+            check(record.entity, header.numTrucks);
+            check(record.target, header.numStations);
+            _stationVisits.emplace_back(record.entity, record.target);
+            break;
+        }
+    });
+
+    // Close the open intervals at the end of the day
+    const SimTime lastTick = static_cast<SimTime>(header.ticksPerDay) - 1;
+    for (std::size_t truck = 0; truck < truckState.size(); ++truck) {
+        _truckTime[truck][index(truckState[truck])] += lastTick - truckEntered[truck];
+    }
+    for (std::size_t station = 0; station < stationState.size(); ++station) {
+        _stationTime[station][index(stationState[station])] += lastTick - stationEntered[station];
+    }
+    for (std::uint32_t site = 0; site < header.numSites; ++site) {
+        setMiningFlag(site, _siteMining[site], lastTick + 1);
+    }
+}
+
+///
+/// \param site
+int MineJournalReplay::getIdleTime(int site) const {
+    return _siteIdleTime[site];
+}
+
+///
+/// \param site
+int MineJournalReplay::getMiningTime(int site) const {
+    return _siteMiningTime[site];
+}
+
+///
+/// \param truck
+/// \param truckState
+int MineJournalReplay::getTimeInState(int truck, TruckState truckState) const {
+    return _truckTime[truck][index(truckState)];
+}
+
+///
+/// \param station
+/// \param stationState
+int MineJournalReplay::getTimeInState(int station, StationState stationState) const {
+    return _stationTime[station][index(stationState)];
+}
+
+/// Outputs the same statistics as the simulation that wrote the journal
+/// \param stats
+void MineJournalReplay::outputStatistics(MineStatsSink& stats) const {
+    for (std::size_t truck = 0; truck < _truckTime.size(); ++truck) {
+        stats.addTruck(static_cast<int>(truck), _truckTime[truck]);
+    }
+    for (std::size_t station = 0; station < _stationTime.size(); ++station) {
+        stats.addStation(static_cast<int>(station), _stationTime[station]);
+    }
+    for (std::size_t site = 0; site < _siteIdleTime.size(); ++site) {
+        stats.addSite(static_cast<int>(site), _siteIdleTime[site], _siteMiningTime[site]);
+    }
+    for (const auto& [truck, station] : _stationVisits) {
+        stats.addStationVisits(static_cast<int>(truck), static_cast<int>(station), 1);
+    }
+}
+
+/// Sets a site's mining flag, accumulating the ticks spent with the old value
+/// \param site
+/// \param beingMined
+/// \param now
+void MineJournalReplay::setMiningFlag(std::uint32_t site, bool beingMined, SimTime now) {
+    auto& siteTime = _siteMining[site] ? _siteMiningTime : _siteIdleTime;
+    siteTime[site] += now - _siteChanged[site];
+    _siteChanged[site] = now;
+    _siteMining[site] = beingMined;
+}
+}  // namespace acme
\ No newline at end of file
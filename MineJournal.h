@@ -0,0 +1,185 @@
+/// \file   MineJournal.h
+/// \brief  Append-only binary journal of state transitions and dispatch decisions
+#pragma once
+#include "MineDefs.h"
+#include "MineStationState.h"
+#include "MineStatsSink.h"
+#include "MineTruckStates.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace acme {
+/// What a JournalRecord describes
+enum class JournalKind : std::uint8_t {
+    TRUCK_STATE,      // entity entered TruckState value
+    STATION_STATE,    // entity entered StationState value
+    SITE_DISPATCH,    // Truck entity was sent to site target
+    STATION_DISPATCH  // Truck entity joined station target's queue in place value
+};
+
+/// \struct JournalHeader
+/// \brief  Start of every journal file
+struct JournalHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t ticksPerDay;
+    std::uint32_t numTrucks;
+    std::uint32_t numStations;
+    std::uint32_t numSites;
+    std::uint32_t reserved;
+    std::uint64_t seed;
+};
+
+/// \struct JournalRecord
+/// \brief  Fixed-size record; the tick is stored as the difference from the previous record's
+struct JournalRecord {
+    JournalKind kind;
+    std::uint8_t value;
+    std::uint16_t tickDelta;
+    std::uint32_t entity;
+    std::uint32_t target;
+};
+
+static_assert(sizeof(JournalHeader) == 40, "JournalHeader is written as is");
+static_assert(sizeof(JournalRecord) == 12, "JournalRecord is written as is");
+
+constexpr std::array<char, 8> JOURNAL_MAGIC{'A', 'C', 'M', 'E', 'J', 'R', 'N', 'L'};
+constexpr std::uint32_t JOURNAL_VERSION = 1;
+
+/// \class  MineJournal
+/// \brief  Buffers JournalRecords and appends them to the journal file in large blocks
+/// \note   Records must be added in non-decreasing tick order, starting from the tick before the
+///         day begins, when the trucks are first sent to their sites
+class MineJournal {
+public:
+    /// Constructor
+    /// \throws std::runtime_error if the file cannot be created
+    MineJournal(
+        const std::string& fileName,
+        int numTrucks,
+        int numStations,
+        int numSites,
+        std::uint64_t seed);
+
+    MineJournal() = delete;
+    MineJournal(const MineJournal&) = delete;
+    MineJournal& operator=(const MineJournal&) = delete;
+
+    ///
+    ~MineJournal();
+
+    /// Writes out the buffered records and closes the file
+    /// \throws std::runtime_error if the journal could not be written in full
+    void close();
+
+    ///
+    void dispatchToSite(SimTime now, int truck, int site);
+
+    ///
+    void dispatchToStation(SimTime now, int truck, int station, int placeInQueue);
+
+    ///
+    void enterState(SimTime now, int truck, TruckState truckState);
+
+    ///
+    void enterState(SimTime now, int station, StationState stationState);
+
+    /// \throws std::runtime_error if the buffered records cannot be written
+    void flush();
+
+private:
+    void append(SimTime now, JournalKind kind, int value, int entity, int target);
+    bool writeBuffer();
+
+    static constexpr std::size_t BUFFER_RECORDS = 1 << 14;
+
+    std::string _fileName;
+    std::ofstream _output;
+    std::vector<JournalRecord> _buffer;
+    SimTime _lastTick{-1};
+};
+
+/// \class  MineJournalReader
+/// \brief  Maps a journal file into memory and decodes its records in one pass
+class MineJournalReader {
+public:
+    /// Constructor
+    /// \throws std::runtime_error if the file cannot be mapped, or is not a journal
+    explicit MineJournalReader(const std::string& fileName);
+
+    MineJournalReader() = delete;
+    MineJournalReader(const MineJournalReader&) = delete;
+    MineJournalReader& operator=(const MineJournalReader&) = delete;
+
+    ///
+    ~MineJournalReader();
+
+    /// Calls visit(tick, record) for every record, in order
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        const auto* bytes = static_cast<const char*>(_mapping) + sizeof(JournalHeader);
+        SimTime tick = -1;
+        JournalRecord record;
+        for (std::size_t index = 0; index < _numRecords; ++index) {
+            std::memcpy(&record, bytes + index * sizeof(JournalRecord), sizeof(JournalRecord));
+            tick += record.tickDelta;
+            visit(tick, record);
+        }
+    }
+
+    ///
+    const JournalHeader& getHeader() const;
+
+    ///
+    std::size_t getNumRecords() const;
+
+private:
+    void* _mapping{nullptr};
+    std::size_t _size{0};
+    std::size_t _numRecords{0};
+    JournalHeader _header{};
+};
+
+/// \class  MineJournalReplay
+/// \brief  Rebuilds the end-of-day statistics from a journal, with the same rules as TruckFleet
+class MineJournalReplay {
+public:
+    ///
+    explicit MineJournalReplay(const MineJournalReader& reader);
+
+    MineJournalReplay() = delete;
+
+    ///
+    int getIdleTime(int site) const;
+
+    ///
+    int getMiningTime(int site) const;
+
+    ///
+    int getTimeInState(int truck, TruckState truckState) const;
+
+    ///
+    int getTimeInState(int station, StationState stationState) const;
+
+    ///
+    void outputStatistics(MineStatsSink& stats) const;
+
+private:
+    void setMiningFlag(std::uint32_t site, bool beingMined, SimTime now);
+
+    std::vector<TruckTimes> _truckTime;
+    std::vector<StationTimes> _stationTime;
+    std::vector<int> _siteIdleTime;
+    std::vector<int> _siteMiningTime;
+    std::vector<std::uint8_t> _siteMining;
+    std::vector<SimTime> _siteChanged;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> _stationVisits;
+};
+}  // namespace acme
\ No newline at end of file
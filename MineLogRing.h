@@ -0,0 +1,98 @@
+/// \file   MineLogRing.h
+/// \brief  Bounded lock-free multi-producer queue feeding the MineLogger writer thread
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace acme {
+/// \class  MineLogRing
+/// \brief  Fixed-capacity ring of cells, each stamped with a sequence number that tells producers
+///         and consumers whose turn it is (Vyukov's bounded queue)
+/// \note   Producers claim a cell with one compare-and-swap and never wait on each other; a full
+///         ring is reported to the caller instead of growing, so memory stays bounded.
+template <typename T>
+class MineLogRing {
+public:
+    /// Constructor
+    /// \param capacity     a power of two
+    explicit MineLogRing(std::size_t capacity)
+        : _cells(new Cell[capacity])
+        , _mask(capacity - 1) {
+        assert(capacity >= 2 && (capacity & _mask) == 0);
+        for (std::size_t cell = 0; cell < capacity; ++cell) {
+            _cells[cell].sequence.store(cell, std::memory_order_relaxed);
+        }
+    }
+
+    MineLogRing() = delete;
+    MineLogRing(const MineLogRing&) = delete;
+    MineLogRing& operator=(const MineLogRing&) = delete;
+
+    ///
+    std::size_t capacity() const {
+        return _mask + 1;
+    }
+
+    /// Moves the oldest element into value
+    /// \return false if the ring is empty
+    bool tryPop(T& value) {
+        auto position = _dequeuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& cell = _cells[position & _mask];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+            auto lag = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+            if (lag == 0) {
+                if (_dequeuePosition.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(position + _mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = _dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Moves value into the ring
+    /// \return false, leaving value untouched, if the ring is full
+    bool tryPush(T&& value) {
+        auto position = _enqueuePosition.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& cell = _cells[position & _mask];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+            auto lag = static_cast<std::ptrdiff_t>(sequence - position);
+            if (lag == 0) {
+                if (_enqueuePosition.compare_exchange_weak(
+                        position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false;
+            } else {
+                position = _enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    static constexpr std::size_t CACHE_LINE = 64;
+
+    std::unique_ptr<Cell[]> _cells;
+    std::size_t _mask;
+    alignas(CACHE_LINE) std::atomic<std::size_t> _enqueuePosition{0};
+    alignas(CACHE_LINE) std::atomic<std::size_t> _dequeuePosition{0};
+};
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,138 @@
+/// \file   MineLogger.cpp
+#include "MineLogger.h"
+
+#include "MineTrace.h"
+
+#include <chrono>
+#include <iostream>
+
+namespace acme {
+namespace {
+/// How long the writer thread sleeps when there is nothing to write
+constexpr std::chrono::milliseconds IDLE_WAIT{1};
+
+/// Most messages written per batch, so the console sees progress under a steady load
+constexpr std::size_t MAX_BATCH = 4096;
+}  // namespace
+
+/// Opens the log file and starts the writer thread
+MineLogger::MineLogger() {
+    auto dateStamp = createISODateStamp();
+    std::string acmeLog(dateStamp + "_AcmeMinerSim.log");
+    _logfile.open(acmeLog, std::ios::app);
+    _writer = std::thread(&MineLogger::writerLoop, this);
+}
+
+/// Writes out every message still in the ring, then stops the writer thread
+MineLogger::~MineLogger() {
+    _stopping.store(true, std::memory_order_release);
+    _writer.join();
+    if (_logfile.is_open()) {
+        _logfile.close();
+    }
+}
+
+/// Waits until every message logged so far has been written
+void MineLogger::flush() {
+    auto pushed = _pushed.load(std::memory_order_acquire);
+    while (_written.load(std::memory_order_acquire) < pushed) {
+        std::this_thread::sleep_for(IDLE_WAIT);
+    }
+}
+
+/// Returns the bytes written to the log file so far
+std::uint64_t MineLogger::getBytesWritten() const {
+    return _bytesWritten.load(std::memory_order_relaxed);
+}
+
+/// Returns the number of messages discarded under LogFullPolicy::DROP
+std::uint64_t MineLogger::getDroppedCount() const {
+    return _dropped.load(std::memory_order_relaxed);
+}
+
+/// Returns the number of messages logged so far, not counting the dropped ones
+std::uint64_t MineLogger::getLoggedCount() const {
+    return _pushed.load(std::memory_order_relaxed);
+}
+
+/// Queues a message for the writer thread
+/// \param msg
+void MineLogger::logMessage(std::string msg) {
+    while (!_ring.tryPush(std::move(msg))) {
+        if (_fullPolicy.load(std::memory_order_relaxed) == LogFullPolicy::DROP) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+    _pushed.fetch_add(1, std::memory_order_release);
+}
+
+/// Echoes messages to the console as well as the log file, which is the default
+/// \param console
+void MineLogger::setConsole(bool console) {
+    _console.store(console, std::memory_order_relaxed);
+}
+
+///
+/// \param fullPolicy
+void MineLogger::setFullPolicy(LogFullPolicy fullPolicy) {
+    _fullPolicy.store(fullPolicy, std::memory_order_relaxed);
+}
+
+///
+/// \param category
+/// \param level
+void MineLogger::setLevel(LogCategory category, LogLevel level) {
+    _levels[static_cast<std::size_t>(category)].store(level, std::memory_order_relaxed);
+}
+
+///
+/// \param sampleRate
+void MineLogger::setSampleRate(int sampleRate) {
+    _sampleRate.store(sampleRate, std::memory_order_relaxed);
+}
+
+/// Drains the ring in batches, one write and one flush per batch and destination
+void MineLogger::writerLoop() {
+    MineTrace::getInstance().setThreadName("log writer");
+    std::string batch;
+    std::string msg;
+    std::uint64_t reportedDropped = 0;
+
+    for (;;) {
+        // Read the flag first, so that everything logged before it was set is still drained
+        auto stopping = _stopping.load(std::memory_order_acquire);
+
+        std::size_t count = 0;
+        while (count < MAX_BATCH && _ring.tryPop(msg)) {
+            batch.append(msg).push_back('\n');
+            ++count;
+        }
+
+        auto dropped = _dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDropped) {
+            batch.append(std::to_string(dropped - reportedDropped))
+                .append(" log messages dropped\n");
+            reportedDropped = dropped;
+        }
+
+        if (!batch.empty()) {
+            auto span = MineTraceSpan("writeLog");
+            if (_console.load(std::memory_order_relaxed)) {
+                std::cout.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                std::cout.flush();
+            }
+            _logfile.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            _logfile.flush();
+            _bytesWritten.fetch_add(batch.size(), std::memory_order_relaxed);
+            batch.clear();
+            _written.fetch_add(count, std::memory_order_release);
+        } else if (stopping) {
+            return;
+        } else {
+            std::this_thread::sleep_for(IDLE_WAIT);
+        }
+    }
+}
+}  // namespace acme
\ No newline at end of file
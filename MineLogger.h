@@ -2,14 +2,54 @@
 /// \brief  Simple logging singleton
 #pragma once
 #include "AcmeMinerUtils.h"
+#include "MineLogRing.h"
+#include "MineMetrics.h"
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <fstream>
-#include <iostream>
-#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
+
+/// Most verbose LogLevel compiled in; ACME_LOG messages above it are removed altogether
+#ifndef ACME_LOG_CEILING
+#define ACME_LOG_CEILING 4
+#endif
+
+/// Logs a message built with operator<<, such as ACME_LOG(INFO, TRUCK, id, "a" << 1), only if its
+/// level is compiled in and enabled for the category and entity; otherwise nothing is formatted
+#define ACME_LOG(level, category, entity, message)                                             \
+    do {                                                                                       \
+        if constexpr (static_cast<int>(::acme::LogLevel::level) <= ACME_LOG_CEILING) {         \
+            auto& acmeLogger = ::acme::MineLogger::getInstance();                              \
+            if (acmeLogger.isEnabled(                                                          \
+                    ::acme::LogLevel::level, ::acme::LogCategory::category, entity)) {         \
+                ::acme::MinePhaseTimer acmeLogTimer(::acme::MetricPhase::LOGGING);             \
+                std::ostringstream acmeLogStream;                                              \
+                acmeLogStream << message;                                                      \
+                acmeLogger.logMessage(acmeLogStream.str());                                    \
+            }                                                                                  \
+        }                                                                                      \
+    } while (false)
 
 namespace acme {
-///
+/// Message verbosity, from least to most verbose
+enum class LogLevel : std::uint8_t { OFF, ERROR, WARNING, INFO, DEBUG };
+
+/// Message sources that can be filtered separately
+enum class LogCategory : std::uint8_t { TRUCK, STATION, DISPATCHER };
+constexpr std::size_t NUM_LOG_CATEGORIES = 3;
+/// What MineLogger::logMessage does when the writer thread has fallen behind
+enum class LogFullPolicy {
+    BLOCK,  // Wait for room, so no message is ever lost
+    DROP    // Discard the message, and report how many were discarded
+};
+
+/// \class  MineLogger
+/// \note   Messages are handed to a background thread through a bounded lock-free ring; the
+///         thread writes them to the console and the log file in batches, flushing once per batch
 class MineLogger {
 public:
     ///
@@ -19,33 +59,65 @@ public:
     }
 
     ///
-    void logMessage(const std::string& msg) {
-        std::cout << msg << std::endl;
+    void flush();
 
-        std::lock_guard<std::mutex> lockGuard(_mutex);
-        _logfile << msg << std::endl;
+    /// Returns the bytes written to the log file so far
+    std::uint64_t getBytesWritten() const;
+
+    ///
+    std::uint64_t getDroppedCount() const;
+
+    /// Returns the number of messages logged so far, not counting the dropped ones
+    std::uint64_t getLoggedCount() const;
+
+    /// True if a message at this level is enabled for the category, and the entity is sampled
+    bool isEnabled(LogLevel level, LogCategory category, int entity) const {
+        return level <= _levels[static_cast<std::size_t>(category)].load(std::memory_order_relaxed)
+               && entity % _sampleRate.load(std::memory_order_relaxed) == 0;
     }
 
+    ///
+    void logMessage(std::string msg);
+
+    /// Echoes messages to the console as well as the log file, which is the default
+    void setConsole(bool console);
+
+    ///
+    void setFullPolicy(LogFullPolicy fullPolicy);
+
+    ///
+    void setLevel(LogCategory category, LogLevel level);
+
+    /// Only entities whose id is a multiple of sampleRate are logged
+    void setSampleRate(int sampleRate);
+
     ///
     MineLogger(const MineLogger&) = delete;
     MineLogger& operator=(const MineLogger&) = delete;
 
 private:
     ///
-    MineLogger() {
-        auto dateStamp = createISODateStamp();
-        std::string acmeLog(dateStamp + "_AcmeMinerSim.log");
-        _logfile.open(acmeLog, std::ios::app);
-    };
+    MineLogger();
 
     ///
-    ~MineLogger() {
-        if (_logfile.is_open()) {
-            _logfile.close();
-        }
-    }
+    ~MineLogger();
+
+    void writerLoop();
+
+    static constexpr std::size_t RING_CAPACITY = 1 << 16;
 
-    std::mutex _mutex;
     std::ofstream _logfile;
+    MineLogRing<std::string> _ring{RING_CAPACITY};
+    std::atomic<bool> _console{true};
+    std::atomic<LogFullPolicy> _fullPolicy{LogFullPolicy::BLOCK};
+    std::array<std::atomic<LogLevel>, NUM_LOG_CATEGORIES> _levels{
+        LogLevel::INFO, LogLevel::INFO, LogLevel::INFO};
+    std::atomic<int> _sampleRate{1};
+    std::atomic<std::uint64_t> _pushed{0};
+    std::atomic<std::uint64_t> _written{0};
+    std::atomic<std::uint64_t> _bytesWritten{0};
+    std::atomic<std::uint64_t> _dropped{0};
+    std::atomic<bool> _stopping{false};
+    std::thread _writer;
 };
 }  // namespace acme
\ No newline at end of file
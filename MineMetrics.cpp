@@ -0,0 +1,274 @@
+/// \file   MineMetrics.cpp
+#include "MineMetrics.h"
+
+#include "MineLogger.h"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace acme {
+namespace {
+constexpr std::array<const char*, NUM_DISPATCH_OPS> DISPATCH_OP_NAME{
+    "siteEnqueue", "siteDequeue", "stationEnqueue", "stationSelect"};
+
+constexpr std::array<const char*, 4> HARDWARE_EVENT_NAME{
+    "cycles", "instructions", "cacheMisses", "branchMisses"};
+
+#ifdef __linux__
+constexpr std::array<std::uint64_t, 4> HARDWARE_EVENT{
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES};
+
+/// Opens a disabled counter of a hardware event for this thread and the threads it starts
+int openHardwareCounter(std::uint64_t event) {
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = event;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+/// Writes "name": value pairs as a JSON object
+template <typename Names, typename Values>
+void writeJsonObject(std::ostream& output, const Names& names, const Values& values) {
+    output << '{';
+    for (std::size_t entry = 0; entry < names.size(); ++entry) {
+        output << (entry != 0 ? ", " : "") << '"' << names[entry] << "\": " << values[entry];
+    }
+    output << '}';
+}
+}  // namespace
+
+/// Closes the hardware counters, if they are still open
+MineMetrics::~MineMetrics() {
+    stopHardwareCounters();
+}
+
+/// \param phase
+/// \param elapsed
+void MineMetrics::addPhaseTime(MetricPhase phase, Clock::duration elapsed) {
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    _phaseNanos[static_cast<std::size_t>(phase)].fetch_add(
+        static_cast<std::uint64_t>(nanos), std::memory_order_relaxed);
+    _phaseTimedCalls[static_cast<std::size_t>(phase)].fetch_add(1, std::memory_order_relaxed);
+}
+
+///
+/// \param bytes
+void MineMetrics::addStatsBytes(std::size_t bytes) {
+    _statsBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/// Returns a snapshot of the counters
+MineMetricCounts MineMetrics::getCounts() const {
+    MineMetricCounts counts;
+    for (std::size_t state = 0; state < NUM_TRUCK_STATES; ++state) {
+        counts.truckTransitions[state] =
+            _counts.truckTransitions[state].load(std::memory_order_relaxed);
+    }
+    for (std::size_t state = 0; state < NUM_STATION_STATES; ++state) {
+        counts.stationTransitions[state] =
+            _counts.stationTransitions[state].load(std::memory_order_relaxed);
+    }
+    for (std::size_t op = 0; op < NUM_DISPATCH_OPS; ++op) {
+        counts.dispatchOps[op] = _counts.dispatchOps[op].load(std::memory_order_relaxed);
+    }
+    return counts;
+}
+
+///
+/// \param phase
+double MineMetrics::getPhaseMs(MetricPhase phase) const {
+    auto nanos = _phaseNanos[static_cast<std::size_t>(phase)].load(std::memory_order_relaxed);
+    auto calls = _phaseCalls[static_cast<std::size_t>(phase)].load(std::memory_order_relaxed);
+    auto timed = _phaseTimedCalls[static_cast<std::size_t>(phase)].load(std::memory_order_relaxed);
+    if (timed == 0) {
+        return 0;
+    }
+    return static_cast<double>(nanos) * static_cast<double>(calls) / static_cast<double>(timed)
+           / 1e6;
+}
+
+///
+std::uint64_t MineMetrics::getStatsBytes() const {
+    return _statsBytes.load(std::memory_order_relaxed);
+}
+
+/// \param counts
+void MineMetrics::merge(const MineMetricCounts& counts) {
+    for (std::size_t state = 0; state < NUM_TRUCK_STATES; ++state) {
+        _counts.truckTransitions[state].fetch_add(
+            counts.truckTransitions[state], std::memory_order_relaxed);
+    }
+    for (std::size_t state = 0; state < NUM_STATION_STATES; ++state) {
+        _counts.stationTransitions[state].fetch_add(
+            counts.stationTransitions[state], std::memory_order_relaxed);
+    }
+    for (std::size_t op = 0; op < NUM_DISPATCH_OPS; ++op) {
+        _counts.dispatchOps[op].fetch_add(counts.dispatchOps[op], std::memory_order_relaxed);
+    }
+}
+
+/// Logs one line each for the phase times, the transitions, the dispatcher operations, the bytes
+/// written, and the hardware counters
+void MineMetrics::report() const {
+    auto& logger = MineLogger::getInstance();
+    auto counts = getCounts();
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << "Metrics: setup "
+        << getPhaseMs(MetricPhase::SETUP) << " ms, tick update "
+        << getPhaseMs(MetricPhase::TICK_UPDATE) << " ms (dispatch ~"
+        << getPhaseMs(MetricPhase::DISPATCH) << " ms, logging ~"
+        << getPhaseMs(MetricPhase::LOGGING) << " ms), statistics output "
+        << getPhaseMs(MetricPhase::STATS_OUTPUT) << " ms";
+    logger.logMessage(oss.str());
+
+    oss.str("");
+    oss << "Metrics: truck transitions";
+    for (std::size_t state = 0; state < NUM_TRUCK_STATES; ++state) {
+        oss << ' ' << TRUCK_STATE_NAME[state] << ' ' << counts.truckTransitions[state];
+    }
+    oss << ", station transitions";
+    for (std::size_t state = 0; state < NUM_STATION_STATES; ++state) {
+        oss << ' ' << STATION_STATE_NAME[state] << ' ' << counts.stationTransitions[state];
+    }
+    logger.logMessage(oss.str());
+
+    oss.str("");
+    oss << "Metrics: dispatcher operations";
+    for (std::size_t op = 0; op < NUM_DISPATCH_OPS; ++op) {
+        oss << ' ' << DISPATCH_OP_NAME[op] << ' ' << counts.dispatchOps[op];
+    }
+    logger.logMessage(oss.str());
+
+    oss.str("");
+    oss << "Metrics: " << logger.getLoggedCount() << " log records, " << logger.getBytesWritten()
+        << " log bytes written, " << getStatsBytes() << " statistics bytes written";
+    logger.logMessage(oss.str());
+
+    oss.str("");
+    oss << "Metrics: hardware counters";
+    if (!_hardwareRead) {
+        oss << " unavailable";
+    }
+    for (std::size_t event = 0; _hardwareRead && event < NUM_HARDWARE_EVENTS; ++event) {
+        oss << ' ' << HARDWARE_EVENT_NAME[event] << ' ' << _hardwareCounts[event];
+    }
+    logger.logMessage(oss.str());
+}
+
+/// Clears every phase time and counter, including the hardware counts last read
+void MineMetrics::reset() {
+    for (auto& counter : _counts.truckTransitions) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto& counter : _counts.stationTransitions) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (auto& counter : _counts.dispatchOps) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (std::size_t phase = 0; phase < NUM_METRIC_PHASES; ++phase) {
+        _phaseCalls[phase].store(0, std::memory_order_relaxed);
+        _phaseTimedCalls[phase].store(0, std::memory_order_relaxed);
+        _phaseNanos[phase].store(0, std::memory_order_relaxed);
+    }
+    _statsBytes.store(0, std::memory_order_relaxed);
+    _hardwareCounts = {};
+    _hardwareRead = false;
+}
+
+/// Opens and enables one counter per hardware event; any event that cannot be counted disables
+/// them all, as perf_event_open is often restricted in containers and virtual machines
+bool MineMetrics::startHardwareCounters() {
+#ifdef __linux__
+    for (std::size_t event = 0; event < NUM_HARDWARE_EVENTS; ++event) {
+        _hardwareFds[event] = openHardwareCounter(HARDWARE_EVENT[event]);
+        if (_hardwareFds[event] < 0) {
+            stopHardwareCounters();
+            return false;
+        }
+    }
+    for (auto fd : _hardwareFds) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// Reads and closes the hardware counters, if they are all open
+void MineMetrics::stopHardwareCounters() {
+#ifdef __linux__
+    auto allOpen = true;
+    for (auto fd : _hardwareFds) {
+        allOpen &= fd >= 0;
+    }
+    for (std::size_t event = 0; event < NUM_HARDWARE_EVENTS; ++event) {
+        auto& fd = _hardwareFds[event];
+        if (fd < 0) {
+            continue;
+        }
+        if (allOpen) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            std::uint64_t count = 0;
+            if (read(fd, &count, sizeof(count)) == sizeof(count)) {
+                _hardwareCounts[event] = count;
+            }
+        }
+        close(fd);
+        fd = -1;
+    }
+    _hardwareRead |= allOpen;
+#endif
+}
+
+/// \param fileName
+void MineMetrics::writeJson(const std::string& fileName) const {
+    auto& logger = MineLogger::getInstance();
+    auto counts = getCounts();
+
+    std::ofstream output(fileName, std::ios::trunc);
+    output << std::fixed << std::setprecision(3) << "{\n  \"phaseMs\": ";
+    std::array<double, NUM_METRIC_PHASES> phaseMs{};
+    for (std::size_t phase = 0; phase < NUM_METRIC_PHASES; ++phase) {
+        phaseMs[phase] = getPhaseMs(static_cast<MetricPhase>(phase));
+    }
+    writeJsonObject(output, METRIC_PHASE_NAME, phaseMs);
+
+    output << ",\n  \"truckTransitions\": ";
+    writeJsonObject(output, TRUCK_STATE_NAME, counts.truckTransitions);
+    output << ",\n  \"stationTransitions\": ";
+    writeJsonObject(output, STATION_STATE_NAME, counts.stationTransitions);
+    output << ",\n  \"dispatcherOperations\": ";
+    writeJsonObject(output, DISPATCH_OP_NAME, counts.dispatchOps);
+
+    output << ",\n  \"logRecords\": " << logger.getLoggedCount()
+           << ",\n  \"logBytesWritten\": " << logger.getBytesWritten()
+           << ",\n  \"statsBytesWritten\": " << getStatsBytes() << ",\n  \"hardwareCounters\": ";
+    if (_hardwareRead) {
+        writeJsonObject(output, HARDWARE_EVENT_NAME, _hardwareCounts);
+    } else {
+        output << "null";
+    }
+    output << "\n}\n";
+}
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,206 @@
+/// \file   MineMetrics.h
+/// \brief  Phase timers and counters that are always collected, and reported at the end of a run
+#pragma once
+#include "MineStationState.h"
+#include "MineTrace.h"
+#include "MineTruckStates.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace acme {
+/// Phases of a run; DISPATCH and LOGGING are part of TICK_UPDATE
+enum class MetricPhase : std::uint8_t { SETUP, TICK_UPDATE, DISPATCH, LOGGING, STATS_OUTPUT };
+constexpr std::size_t NUM_METRIC_PHASES = 5;
+
+/// Enum to string mapping, as the phases are named in reports and traces
+constexpr std::array<const char*, NUM_METRIC_PHASES> METRIC_PHASE_NAME{
+    "setup", "tickUpdate", "dispatch", "logging", "statsOutput"};
+
+/// Dispatcher operations
+enum class DispatchOp : std::uint8_t {
+    SITE_ENQUEUE,
+    SITE_DEQUEUE,
+    STATION_ENQUEUE,  // A MineStation added, or moved after its queue changed
+    STATION_SELECT    // The MineStation with the shortest queue looked up
+};
+constexpr std::size_t NUM_DISPATCH_OPS = 4;
+
+/// \struct MineMetricCounts
+/// \brief  Plain counters, for code that counts on its own and merges the totals into MineMetrics
+struct MineMetricCounts {
+    std::array<std::uint64_t, NUM_TRUCK_STATES> truckTransitions{};
+    std::array<std::uint64_t, NUM_STATION_STATES> stationTransitions{};
+    std::array<std::uint64_t, NUM_DISPATCH_OPS> dispatchOps{};
+};
+
+/// \class  MineMetrics
+/// \brief  Times the phases of a run, and counts transitions, dispatcher operations and the bytes
+///         written to the statistics files; optionally reads hardware counters as well
+/// \note   The count* methods are only called from the simulation thread, so they add without a
+///         locked instruction; other threads merge their totals. DISPATCH and LOGGING calls are too
+///         short to time every one of them, so only one in SAMPLE_PERIOD is timed, and their time
+///         is scaled up by the number of calls; the first call pays for first-use setup, so the
+///         last call of each period is timed instead
+class MineMetrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// One in this many calls of DISPATCH and LOGGING is timed
+    static constexpr std::uint64_t SAMPLE_PERIOD = 64;
+
+    ///
+    static MineMetrics& getInstance() {
+        static MineMetrics instance;
+        return instance;
+    }
+
+    MineMetrics(const MineMetrics&) = delete;
+    MineMetrics& operator=(const MineMetrics&) = delete;
+
+    /// Adds the time of a timed call to a phase; from any thread
+    void addPhaseTime(MetricPhase phase, Clock::duration elapsed);
+
+    /// Adds bytes written to the statistics files; from any thread
+    void addStatsBytes(std::size_t bytes);
+
+    /// Counts a call to a phase, and returns true if it is to be timed; sampled phases time the
+    /// last call of every SAMPLE_PERIOD
+    bool beginPhase(MetricPhase phase) {
+        auto& calls = _phaseCalls[static_cast<std::size_t>(phase)];
+        if (phase != MetricPhase::DISPATCH && phase != MetricPhase::LOGGING) {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        auto call = calls.load(std::memory_order_relaxed);
+        calls.store(call + 1, std::memory_order_relaxed);
+        return call % SAMPLE_PERIOD == SAMPLE_PERIOD - 1;
+    }
+
+    ///
+    void countDispatch(DispatchOp op) {
+        bump(_counts.dispatchOps[static_cast<std::size_t>(op)]);
+    }
+
+    ///
+    void countTransition(StationState stationState) {
+        bump(_counts.stationTransitions[index(stationState)]);
+    }
+
+    ///
+    void countTransition(TruckState truckState) {
+        bump(_counts.truckTransitions[index(truckState)]);
+    }
+
+    ///
+    MineMetricCounts getCounts() const;
+
+    /// Returns the time spent in a phase, scaled up from the timed calls where they are sampled
+    double getPhaseMs(MetricPhase phase) const;
+
+    ///
+    std::uint64_t getStatsBytes() const;
+
+    /// Adds counts gathered elsewhere; from any thread
+    void merge(const MineMetricCounts& counts);
+
+    /// Logs the summary of every phase time and counter
+    void report() const;
+
+    /// Clears every phase time and counter, e.g. between simulations
+    void reset();
+
+    /// Starts counting cycles, instructions, cache misses and branch misses in this process, from
+    /// this thread and the threads it starts afterwards, if the kernel allows it
+    /// \return false if hardware counters are not available
+    bool startHardwareCounters();
+
+    ///
+    void stopHardwareCounters();
+
+    /// Writes the summary as JSON
+    void writeJson(const std::string& fileName) const;
+
+private:
+    MineMetrics() = default;
+    ~MineMetrics();
+
+    /// Counters written by a single thread
+    using Counter = std::atomic<std::uint64_t>;
+
+    static void bump(Counter& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    /// Hardware events read through perf_event_open
+    static constexpr std::size_t NUM_HARDWARE_EVENTS = 4;
+
+    struct Counts {
+        std::array<Counter, NUM_TRUCK_STATES> truckTransitions{};
+        std::array<Counter, NUM_STATION_STATES> stationTransitions{};
+        std::array<Counter, NUM_DISPATCH_OPS> dispatchOps{};
+    };
+
+    Counts _counts;
+    std::array<Counter, NUM_METRIC_PHASES> _phaseCalls{};
+    std::array<Counter, NUM_METRIC_PHASES> _phaseTimedCalls{};
+    std::array<Counter, NUM_METRIC_PHASES> _phaseNanos{};
+    Counter _statsBytes{0};
+
+    std::array<int, NUM_HARDWARE_EVENTS> _hardwareFds{-1, -1, -1, -1};
+    std::array<std::uint64_t, NUM_HARDWARE_EVENTS> _hardwareCounts{};
+    bool _hardwareRead{false};
+};
+
+/// \class  MinePhaseTimer
+/// \brief  Adds the time from its construction to stop(), or its destruction, to a MetricPhase,
+///         and records it as a MineTrace span if tracing is enabled
+class MinePhaseTimer {
+public:
+    ///
+    explicit MinePhaseTimer(MetricPhase phase)
+        : _phase(phase)
+        , _timed(MineMetrics::getInstance().beginPhase(phase))
+        , _traced(MineTrace::isEnabled()) {
+        if (_timed || _traced) {
+            _start = MineMetrics::Clock::now();
+        }
+    }
+
+    MinePhaseTimer() = delete;
+    MinePhaseTimer(const MinePhaseTimer&) = delete;
+    MinePhaseTimer& operator=(const MinePhaseTimer&) = delete;
+
+    ///
+    ~MinePhaseTimer() {
+        stop();
+    }
+
+    /// Ends the timed call early; later calls do nothing
+    void stop() {
+        if (!_timed && !_traced) {
+            return;
+        }
+        auto end = MineMetrics::Clock::now();
+        if (_timed) {
+            MineMetrics::getInstance().addPhaseTime(_phase, end - _start);
+        }
+        if (_traced) {
+            MineTrace::getInstance().record(
+                METRIC_PHASE_NAME[static_cast<std::size_t>(_phase)], _start, end);
+        }
+        _timed = false;
+        _traced = false;
+    }
+
+private:
+    MetricPhase _phase;
+    bool _timed;
+    bool _traced;
+    MineMetrics::Clock::time_point _start;
+};
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,282 @@
+/// \file   MineOptions.cpp
+#include "MineOptions.h"
+
+#include <chrono>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace acme {
+namespace {
+/// Applies a --log-level value, either LEVEL for every category or CATEGORY:LEVEL for one
+/// \throws std::invalid_argument if a name is unknown
+void parseLogLevel(const std::string& value, MineOptions& options) {
+    constexpr const char* LEVEL_NAMES[]{"off", "error", "warning", "info", "debug"};
+    constexpr const char* CATEGORY_NAMES[]{"truck", "station", "dispatcher"};
+
+    auto find = [](const auto& names, const std::string& name) {
+        for (std::size_t index = 0; index < std::size(names); ++index) {
+            if (name == names[index]) {
+                return index;
+            }
+        }
+        throw std::invalid_argument(name);
+    };
+
+    auto separator = value.find(':');
+    auto level = static_cast<LogLevel>(find(LEVEL_NAMES, value.substr(separator + 1)));
+    if (separator == std::string::npos) {
+        options.logLevels.fill(level);
+    } else {
+        options.logLevels[find(CATEGORY_NAMES, value.substr(0, separator))] = level;
+    }
+}
+
+/// Parses a range, given as VALUE, FIRST:LAST or FIRST:LAST:STEP
+/// \throws std::invalid_argument if it is malformed, or holds no values
+MineRange parseRange(const std::string& value) {
+    MineRange range;
+    std::istringstream fields(value);
+    std::string field;
+    std::getline(fields, field, ':');
+    range.first = std::stoi(field);
+    range.last = std::getline(fields, field, ':') ? std::stoi(field) : range.first;
+    range.step = std::getline(fields, field, ':') ? std::stoi(field) : 1;
+    if (std::getline(fields, field) || range.step < 1 || range.size() == 0) {
+        throw std::invalid_argument(value);
+    }
+    return range;
+}
+
+/// Parses a --what-if value, a comma-separated list of stations+N, trucks-N and transit=TICKS
+/// \throws std::invalid_argument if a change is unknown or out of range
+MineWhatIf parseWhatIf(const std::string& value) {
+    MineWhatIf whatIf;
+    whatIf.label = value;
+    std::istringstream changes(value);
+    for (std::string change; std::getline(changes, change, ',');) {
+        if (change.rfind("stations+", 0) == 0) {
+            whatIf.addedStations = std::stoi(change.substr(9));
+        } else if (change.rfind("trucks-", 0) == 0) {
+            whatIf.removedTrucks = std::stoi(change.substr(7));
+        } else if (change.rfind("transit=", 0) == 0) {
+            // A transit is at least a tick, as with --transit; a branch without one keeps it
+            whatIf.transitTime = std::stoi(change.substr(8));
+            if (whatIf.transitTime < 1) {
+                throw std::invalid_argument(change);
+            }
+        } else {
+            throw std::invalid_argument(change);
+        }
+    }
+    if (whatIf.addedStations < 0 || whatIf.removedTrucks < 0) {
+        throw std::invalid_argument(value);
+    }
+    return whatIf;
+}
+}  // namespace
+
+/// Parses the acme-mining command line
+/// \param argc
+/// \param argv
+/// \param options
+/// \return false if the command line is malformed
+bool parseOptions(int argc, char** argv, MineOptions& options) {
+    if (argc < 3) {
+        return false;
+    }
+
+    auto seeded = false;
+    auto threaded = false;
+    auto fleetParameters = false;
+    auto durationsGiven = false;
+    auto paced = false;
+    auto& grid = options.sweepGrid;
+    try {
+        grid.trucks = parseRange(argv[1]);
+        grid.stations = parseRange(argv[2]);
+
+        for (auto arg = 3; arg < argc; ++arg) {
+            std::string option(argv[arg]);
+            if (option == "--engine=tick") {
+                options.engine = SimEngine::TICK;
+            } else if (option == "--engine=event") {
+                options.engine = SimEngine::EVENT;
+            } else if (option == "--engine=fleet") {
+                options.engine = SimEngine::FLEET;
+            } else if (option == "--log-full=block") {
+                options.logFullPolicy = LogFullPolicy::BLOCK;
+            } else if (option == "--log-full=drop") {
+                options.logFullPolicy = LogFullPolicy::DROP;
+            } else if (option.rfind("--log-level=", 0) == 0) {
+                parseLogLevel(option.substr(12), options);
+            } else if (option.rfind("--log-sample=", 0) == 0) {
+                options.logSampleRate = std::stoi(option.substr(13));
+            } else if (option.rfind("--checkpoint=", 0) == 0) {
+                options.checkpointTick = std::stoi(option.substr(13));
+            } else if (option.rfind("--sites=", 0) == 0) {
+                grid.sites = parseRange(option.substr(8));
+                fleetParameters = true;
+            } else if (option.rfind("--transit=", 0) == 0) {
+                grid.transitTime = parseRange(option.substr(10));
+                fleetParameters = true;
+                durationsGiven = true;
+            } else if (option.rfind("--unloading=", 0) == 0) {
+                grid.unloadingTime = parseRange(option.substr(12));
+                fleetParameters = true;
+                durationsGiven = true;
+            } else if (option.rfind("--mining-min=", 0) == 0) {
+                grid.miningMin = parseRange(option.substr(13));
+                fleetParameters = true;
+                durationsGiven = true;
+            } else if (option.rfind("--mining-max=", 0) == 0) {
+                grid.miningMax = parseRange(option.substr(13));
+                fleetParameters = true;
+                durationsGiven = true;
+            } else if (option.rfind("--branch=", 0) == 0) {
+                options.branchTick = std::stoi(option.substr(9));
+            } else if (option.rfind("--what-if=", 0) == 0) {
+                options.whatIfs.push_back(parseWhatIf(option.substr(10)));
+            } else if (option.rfind("--resume=", 0) == 0) {
+                options.resumeFrom = option.substr(9);
+            } else if (option == "--journal") {
+                options.journal = true;
+            } else if (option == "--no-stats") {
+                options.statistics = false;
+            } else if (option == "--trace") {
+                options.trace = true;
+            } else if (option == "--unthrottled") {
+                options.realTimeFactor = 0;
+            } else if (option.rfind("--rtf=", 0) == 0) {
+                options.realTimeFactor = std::stod(option.substr(6));
+                paced = true;
+            } else if (option.rfind("--threads=", 0) == 0) {
+                options.numThreads = std::stoi(option.substr(10));
+                threaded = true;
+            } else if (option.rfind("--replications=", 0) == 0) {
+                options.numReplications = std::stoi(option.substr(15));
+            } else if (option.rfind("--seed=", 0) == 0) {
+                options.seed = std::stoull(option.substr(7));
+                seeded = true;
+            } else {
+                return false;
+            }
+        }
+    } catch (const std::logic_error&) {
+        return false;
+    }
+
+    // Without a master seed, every run differs, but can be replayed from the seed in the log
+    if (!seeded) {
+        options.seed = static_cast<std::uint64_t>(
+            std::chrono::system_clock::now().time_since_epoch().count());
+    }
+
+    // A single day takes the first value of every parameter
+    options.numTrucks = grid.trucks.first;
+    options.numStations = grid.stations.first;
+    options.numSites = grid.sites.first;
+    options.durations = {
+        grid.transitTime.first,
+        grid.unloadingTime.first,
+        grid.miningMin.first,
+        grid.miningMax.first};
+    const MineRange* ranges[]{
+        &grid.trucks,
+        &grid.stations,
+        &grid.sites,
+        &grid.transitTime,
+        &grid.unloadingTime,
+        &grid.miningMin,
+        &grid.miningMax};
+    for (const auto* range : ranges) {
+        options.sweep = options.sweep || range->size() > 1;
+    }
+
+    // A Monte Carlo batch or a sweep runs on every hardware thread, unless told otherwise
+    if (!threaded && (options.numReplications > 1 || options.sweep)) {
+        options.numThreads = 0;
+    }
+
+    // Every duration is at least a tick, and some mining time range is not empty
+    auto durationsValid = grid.transitTime.first > 0 && grid.unloadingTime.first > 0
+                          && grid.miningMin.first > 0
+                          && grid.miningMin.first <= grid.miningMax.last;
+
+    // Only the TruckFleet takes the number of sites and the durations, or sweeps them; a sweep
+    // runs many whole days, always unthrottled, and none of the single-day modes
+    if ((fleetParameters || options.sweep)
+        && (options.engine != SimEngine::FLEET || options.numReplications != 1 || !durationsValid
+            || grid.sites.first < 0
+            || (grid.sites.first != 0 && grid.sites.last < grid.trucks.first))) {
+        return false;
+    }
+    if (options.sweep
+        && (paced || options.journal || options.checkpointTick >= 0 || !options.resumeFrom.empty()
+            || options.branchTick >= 0)) {
+        return false;
+    }
+
+    // A journal records a single simulation day
+    if (options.journal && options.numReplications != 1) {
+        return false;
+    }
+
+    // Checkpoints snapshot a single TruckFleet day; a journal of a resumed day would start midway,
+    // and a resumed day keeps the durations it was started with
+    auto checkpointed = options.checkpointTick >= 0 || !options.resumeFrom.empty();
+    auto resumed = !options.resumeFrom.empty();
+    if (checkpointed
+        && (options.engine != SimEngine::FLEET || options.numReplications != 1
+            || (resumed && (options.journal || durationsGiven)))) {
+        return false;
+    }
+
+    // Branches are forked from a single-threaded TruckFleet day, so each has a whole copy of it
+    auto branched = options.branchTick >= 0 || !options.whatIfs.empty();
+    if (branched
+        && (options.branchTick < 0 || options.whatIfs.empty() || options.engine != SimEngine::FLEET
+            || options.numThreads != 1 || options.numReplications != 1 || options.journal
+            || options.checkpointTick >= 0)) {
+        return false;
+    }
+
+    // Only the TruckFleet can split a tick across threads, or be seeded for replications
+    if ((options.numThreads != 1 || options.numReplications != 1)
+        && options.engine != SimEngine::FLEET) {
+        return false;
+    }
+
+    return options.numTrucks > 0 && options.numStations > 0 && options.realTimeFactor >= 0
+           && options.numThreads >= 0 && options.numReplications > 0 && options.logSampleRate > 0
+           && options.checkpointTick >= -1 && options.checkpointTick < TICKS_PER_DAY
+           && options.branchTick < TICKS_PER_DAY;
+}
+
+///
+const char* usageMessage() {
+    return "Usage: acme-mining <number-of-trucks> <number-of-stations> [--engine=tick|event|fleet]\n"
+           "                   [--rtf=<real-time-factor> | --unthrottled]\n"
+           "                   [--threads=<number-of-threads>, with --engine=fleet]\n"
+           "                   [--replications=<number-of-days>, with --engine=fleet]\n"
+           "                   [--seed=<master-seed>] [--log-full=block|drop]\n"
+           "                   [--log-level=[<category>:]<level>]\n"
+           "                   [--log-sample=<log-every-nth-truck-and-station>] [--journal]\n"
+           "                   [--no-stats] [--trace]\n"
+           "                   [--checkpoint=<tick>] [--resume=<checkpoint-file>], with "
+           "--engine=fleet\n"
+           "                   [--branch=<tick> --what-if=<change>[,<change>]..., with "
+           "--engine=fleet]\n"
+           "                   where each <change> is stations+<n>, trucks-<n> or "
+           "transit=<ticks>\n"
+           "                   [--sites=<range>] [--transit=<range>] [--unloading=<range>]\n"
+           "                   [--mining-min=<range>] [--mining-max=<range>], with "
+           "--engine=fleet\n"
+           "                   where durations are in ticks, and the number of trucks, the "
+           "number of\n"
+           "                   stations and each option take a <value> or a "
+           "<first>:<last>[:<step>] range;\n"
+           "                   more than one value of any of them sweeps every combination";
+}
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,53 @@
+/// \file   MineOptions.h
+/// \brief  Run options for acme-mining
+#pragma once
+#include "MineBranches.h"
+#include "MineDefs.h"
+#include "MineLogger.h"
+#include "MineSweep.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace acme {
+/// Simulation engines
+enum class SimEngine {
+    TICK,   // The event engine, paced on every tick
+    EVENT,  // Jumps from one state expiration to the next
+    FLEET   // Structure-of-arrays TruckFleet, counted down in one pass per tick
+};
+
+/// \struct MineOptions
+struct MineOptions {
+    int numTrucks{0};
+    int numStations{0};
+    int numSites{0};  // 0 mines one site per truck
+    FleetDurations durations;
+    MineSweepGrid sweepGrid;  // More than one value of any parameter runs a sweep
+    bool sweep{false};
+    SimEngine engine{SimEngine::TICK};
+    double realTimeFactor{REAL_TIME_FACTOR};  // 0 runs as fast as possible
+    int numThreads{1};                        // 0 uses every hardware thread, as batches do
+    int numReplications{1};                   // More than 1 runs a Monte Carlo batch
+    std::uint64_t seed{0};                    // Master seed for every random stream
+    LogFullPolicy logFullPolicy{LogFullPolicy::BLOCK};
+    std::array<LogLevel, NUM_LOG_CATEGORIES> logLevels{
+        LogLevel::INFO, LogLevel::INFO, LogLevel::INFO};
+    int logSampleRate{1};    // Log every Nth truck and station
+    bool journal{false};     // Record every transition in a binary MineJournal
+    bool statistics{true};   // Write the CSV statistics; false discards them
+    bool trace{false};       // Record a MineTrace timeline of the run
+    int checkpointTick{-1};  // Write a checkpoint before this tick; -1 writes none
+    std::string resumeFrom;  // Checkpoint to resume the day from; empty starts it afresh
+    int branchTick{-1};      // Fork the what-if branches before this tick; -1 runs one day
+    std::vector<MineWhatIf> whatIfs;
+};
+
+///
+bool parseOptions(int argc, char** argv, MineOptions& options);
+
+///
+const char* usageMessage();
+}  // namespace acme
\ No newline at end of file
@@ -4,13 +4,11 @@
 #include "AcmeMinerUtils.h"
 #include "MineDefs.h"
 #include "MineDispatchers.h"
-#include "MineLogger.h"
+#include "MineEventEngine.h"
+#include "MinePacer.h"
+#include "MineTrace.h"
 #include "MineTruck.h"
 
-#include <chrono>
-#include <sstream>
-#include <thread>
-
 namespace acme {
 ///
 /// \param minion
@@ -19,41 +17,37 @@ void MineOverlord::attach(MineMinion* minion) {
 }
 
 /// Notifies Observers (MineMinions)
-/// \param timestamp
-void MineOverlord::notify(const std::string& timestamp) {
+/// \param now
+void MineOverlord::notify(SimTime now) {
+    auto span = MineTraceSpan("notify");
     for (auto* minion : _minions) {
-        minion->update(timestamp);
+        minion->update(now);
     }
 }
 
 /// Iterates over MineMinions to output their stats
-void MineOverlord::outputStatistics() {
-    auto timestamp = createISODateStamp();
+/// \param stats
+void MineOverlord::outputStatistics(MineStatsSink& stats) {
     for (auto* minion : _minions) {
-        minion->outputStatistics(timestamp);
+        minion->outputStatistics(stats);
     }
 
     auto truckDispatcher = MineRegistry::getInstance().getTruckDispatcher();
     for (auto truck : truckDispatcher->truckGarage) {
-        truck->outputStationVisits(timestamp);
+        truck->outputStationVisits(stats);
     }
 }
 
 /// Runs through a simulation 'day' (72 hours)
-void MineOverlord::run(int numTrucks, int numStations) {
-    std::ostringstream oss;
-    oss << "ACME Helium-3 Lunar Mining Operations : " << createISODateStamp() << " : ";
-    oss << numTrucks << " mining trucks, " << numStations << " unloading stations";
-    MineLogger::getInstance().logMessage(oss.str());
-    std::string separator(oss.str().length(), '=');
-    MineLogger::getInstance().logMessage(separator);
-
-    for (auto tick = 0; tick < TICKS_PER_DAY; ++tick) {
-        auto timestamp = tickToTimestamp(tick);
-        notify(timestamp);
-
-        // 0.25s sleep
-        std::this_thread::sleep_for(std::chrono::milliseconds(250));
-    }
+/// \param options
+void MineOverlord::run(const MineOptions& options) {
+    logSimulationHeader(options.numTrucks, options.numStations, options.seed);
+
+    // Both engines only wake the MineMinions whose state expires; the fixed-tick engine also paces
+    // every tick, and wakes the MineTrucks that log their progress
+    auto pacer = MinePacer(options.realTimeFactor);
+    MineEventEngine(_minions, options.engine == SimEngine::TICK).run(pacer);
+
+    pacer.report(TICKS_PER_DAY);
 }
 }  // namespace acme
\ No newline at end of file
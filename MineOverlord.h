@@ -1,10 +1,15 @@
 /// \file   MineOverlord.cpp
 /// \brief  Clock publisher for all Mine constructs
 #pragma once
+#include "MineDefs.h"
+#include "MineOptions.h"
+
 #include <string>
 #include <vector>
 
 namespace acme {
+class MineStatsSink;
+
 /// \class  MineMinion
 /// \brief  Observer for MineOverlord
 class MineMinion {
@@ -12,31 +17,37 @@ public:
     ///
     virtual ~MineMinion() = default;
 
+    /// Accounts for ticks that elapsed without an update
+    virtual void advance(int ticks) = 0;
+
+    /// Serial number within the MineMinion's kind
+    virtual int getId() const = 0;
+
     ///
     virtual std::string getName() const = 0;
 
-    ///
-    virtual void outputStatistics(const std::string& timestamp) = 0;
+    /// Adds the MineMinion's statistics to the sink
+    virtual void outputStatistics(MineStatsSink& stats) = 0;
 
     ///
-    virtual void update(const std::string& timestamp) = 0;
+    virtual void update(SimTime now) = 0;
 };
 
 /// \class  MineOverlord
-/// \brief  Subject (Publisher) of simulation timestamps
+/// \brief  Subject (Publisher) of simulation time
 class MineOverlord {
 public:
     ///
     void attach(MineMinion* minion);
 
     ///
-    void notify(const std::string& timestamp);
+    void notify(SimTime now);
 
     ///
-    void outputStatistics();
+    void outputStatistics(MineStatsSink& stats);
 
     ///
-    void run(int numTrucks, int numStations);
+    void run(const MineOptions& options);
 
 private:
     std::vector<MineMinion*> _minions;
@@ -0,0 +1,73 @@
+/// \file   MinePacer.cpp
+#include "MinePacer.h"
+
+#include "MineDefs.h"
+#include "MineLogger.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace acme {
+///
+/// \param realTimeFactor
+/// \param firstTick
+MinePacer::MinePacer(double realTimeFactor, int firstTick)
+    : _start(Clock::now())
+    , _firstTick(firstTick) {
+    if (realTimeFactor > 0) {
+        std::chrono::duration<double> period(SECONDS_PER_TICK / realTimeFactor);
+        _tickPeriod = std::chrono::duration_cast<Clock::duration>(period);
+        _jitter.reserve(TICKS_PER_DAY);
+    }
+}
+
+/// Sleeps until the deadline for a tick, and records how late the wakeup was
+/// \param tick
+void MinePacer::awaitTick(int tick) {
+    if (!isThrottled()) {
+        return;
+    }
+
+    auto deadline = _start + (tick - _firstTick) * _tickPeriod;
+    std::this_thread::sleep_until(deadline);
+    _jitter.push_back(std::max(Clock::now() - deadline, Clock::duration::zero()));
+}
+
+///
+bool MinePacer::isThrottled() const {
+    return _tickPeriod != Clock::duration::zero();
+}
+
+/// Logs the simulation rate and, when throttled, the tick jitter
+/// \param numTicks
+void MinePacer::report(int numTicks) const {
+    std::chrono::duration<double> elapsed = Clock::now() - _start;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3) << "Simulated " << numTicks << " ticks in "
+        << elapsed.count() << " s (" << std::setprecision(0) << (numTicks / elapsed.count())
+        << " ticks/s)";
+    MineLogger::getInstance().logMessage(oss.str());
+
+    if (_jitter.empty()) {
+        return;
+    }
+
+    auto sorted = _jitter;
+    std::sort(sorted.begin(), sorted.end());
+    auto total = Clock::duration::zero();
+    for (auto jitter : sorted) {
+        total += jitter;
+    }
+
+    using Micros = std::chrono::duration<double, std::micro>;
+    auto p99 = sorted[(sorted.size() * 99) / 100];
+    oss.str("");
+    oss << std::fixed << std::setprecision(1) << "Tick jitter over " << sorted.size()
+        << " deadlines: mean " << Micros(total / sorted.size()).count() << " us, p99 "
+        << Micros(p99).count() << " us, max " << Micros(sorted.back()).count() << " us";
+    MineLogger::getInstance().logMessage(oss.str());
+}
+}  // namespace acme
\ No newline at end of file
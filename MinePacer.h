@@ -0,0 +1,38 @@
+/// \file   MinePacer.h
+/// \brief  Paces simulation ticks against wall-clock deadlines
+#pragma once
+#include <chrono>
+#include <vector>
+
+namespace acme {
+/// \class  MinePacer
+/// \brief  Holds each tick to its steady_clock deadline, or lets the simulation run unthrottled
+/// \note   Deadlines are computed from the start of the run rather than from the previous tick,
+///         so oversleeping on one tick does not delay the ones that follow
+class MinePacer {
+public:
+    /// Constructor; a realTimeFactor of 0 runs as fast as possible
+    /// \param realTimeFactor  simulated seconds per wall-clock second
+    /// \param firstTick       tick due at the start, for a day resumed from a checkpoint
+    explicit MinePacer(double realTimeFactor, int firstTick = 0);
+
+    MinePacer() = delete;
+
+    ///
+    void awaitTick(int tick);
+
+    ///
+    bool isThrottled() const;
+
+    ///
+    void report(int numTicks) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::duration _tickPeriod{Clock::duration::zero()};
+    Clock::time_point _start;
+    int _firstTick;
+    std::vector<Clock::duration> _jitter;
+};
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,83 @@
+/// \file   MinePool.h
+/// \brief  Fixed-capacity storage that places objects of one type side by side
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace acme {
+/// \class  MinePool
+/// \brief  Constructs up to a fixed number of objects in one contiguous allocation
+/// \note   Objects never move, so pointers to them stay valid until the MinePool is destroyed,
+///         which destroys them in reverse order and frees the allocation in one go
+template <typename T>
+class MinePool {
+public:
+    /// Constructor; allocates room for every object up front
+    explicit MinePool(std::size_t capacity)
+        : _storage(capacity != 0 ? std::allocator<T>().allocate(capacity) : nullptr)
+        , _capacity(capacity) {}
+
+    MinePool() = delete;
+    MinePool(const MinePool&) = delete;
+    MinePool& operator=(const MinePool&) = delete;
+
+    ///
+    MinePool(MinePool&& other) noexcept
+        : _storage(std::exchange(other._storage, nullptr))
+        , _capacity(std::exchange(other._capacity, 0))
+        , _size(std::exchange(other._size, 0)) {}
+
+    ///
+    ~MinePool() {
+        while (_size != 0) {
+            std::destroy_at(_storage + --_size);
+        }
+        if (_storage != nullptr) {
+            std::allocator<T>().deallocate(_storage, _capacity);
+        }
+    }
+
+    ///
+    T& operator[](std::size_t index) {
+        assert(index < _size);
+        return _storage[index];
+    }
+
+    ///
+    T* begin() {
+        return _storage;
+    }
+
+    ///
+    std::size_t capacity() const {
+        return _capacity;
+    }
+
+    /// Constructs the next object in place
+    template <typename... Args>
+    T* emplace(Args&&... args) {
+        assert(_size < _capacity);
+        auto* object = ::new (static_cast<void*>(_storage + _size)) T(std::forward<Args>(args)...);
+        ++_size;
+        return object;
+    }
+
+    ///
+    T* end() {
+        return _storage + _size;
+    }
+
+    ///
+    std::size_t size() const {
+        return _size;
+    }
+
+private:
+    T* _storage;
+    std::size_t _capacity;
+    std::size_t _size{0};
+};
+}  // namespace acme
\ No newline at end of file
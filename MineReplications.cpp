@@ -0,0 +1,168 @@
+/// \file   MineReplications.cpp
+#include "MineReplications.h"
+
+#include "AcmeMinerUtils.h"
+#include "MineDefs.h"
+#include "MineLogger.h"
+#include "MinePacer.h"
+#include "MineTrace.h"
+#include "MineWorkerPool.h"
+#include "TruckFleet.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+namespace acme {
+namespace {
+/// Two-sided 95% critical values of Student's t distribution, by degrees of freedom
+constexpr double T_CRITICAL_95[]{12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                 2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                 2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                 2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+
+/// Beyond the table, the first-order Cornish-Fisher expansion around the normal quantile
+double tCritical95(int degreesOfFreedom) {
+    constexpr auto tableSize = static_cast<int>(std::size(T_CRITICAL_95));
+    if (degreesOfFreedom <= tableSize) {
+        return T_CRITICAL_95[degreesOfFreedom - 1];
+    }
+    constexpr auto z = 1.959964;
+    return z + (z * z * z + z) / (4.0 * degreesOfFreedom);
+}
+}  // namespace
+
+/// Constructor
+/// \param numTrucks
+/// \param numStations
+/// \param numReplications
+/// \param baseSeed         replication r is seeded with baseSeed + r
+MineReplications::MineReplications(
+    int numTrucks,
+    int numStations,
+    int numReplications,
+    std::uint64_t baseSeed)
+    : _numTrucks(numTrucks)
+    , _numStations(numStations)
+    , _numSites(numTrucks)
+    , _numReplications(numReplications)
+    , _baseSeed(baseSeed) {
+    auto allocate = [](auto& accumulators, int count) {
+        for (auto& accumulator : accumulators) {
+            accumulator.sum.assign(count, 0);
+            accumulator.sumOfSquares.assign(count, 0);
+        }
+    };
+    allocate(_truckTimes, _numTrucks);
+    allocate(_stationTimes, _numStations);
+    allocate(_siteTimes, _numSites);
+}
+
+/// Adds one finished simulation day to the running sums
+/// \param fleet
+void MineReplications::accumulate(const TruckFleet& fleet) {
+    auto add = [](Accumulator& accumulator, int entity, std::int64_t ticks) {
+        accumulator.sum[entity] += ticks;
+        accumulator.sumOfSquares[entity] += ticks * ticks;
+    };
+
+    std::lock_guard<std::mutex> lockGuard(_mutex);
+    for (auto truck = 0; truck < _numTrucks; ++truck) {
+        for (std::size_t state = 0; state < _truckTimes.size(); ++state) {
+            add(_truckTimes[state],
+                truck,
+                fleet.getTimeInState(truck, static_cast<TruckState>(state)));
+        }
+    }
+    for (auto station = 0; station < _numStations; ++station) {
+        for (std::size_t state = 0; state < _stationTimes.size(); ++state) {
+            add(_stationTimes[state],
+                station,
+                fleet.getTimeInState(station, static_cast<StationState>(state)));
+        }
+    }
+    for (auto site = 0; site < _numSites; ++site) {
+        add(_siteTimes[0], site, fleet.getIdleTime(site));
+        add(_siteTimes[1], site, fleet.getMiningTime(site));
+    }
+}
+
+/// Writes one row per entity and statistic, in minutes:
+/// Entity,Measure,Mean,Variance,CI95Low,CI95High
+/// \param timestamp
+void MineReplications::outputSummary(const std::string& timestamp) const {
+    constexpr char TRUCK_PREFIX[]{"ATRK"};
+    constexpr char STATION_PREFIX[]{"ASTN"};
+    constexpr char SITE_PREFIX[]{"ASIT"};
+    constexpr const char* TRUCK_MEASURES[]{"Mining", "Inbound", "Queued", "Unloading", "Outbound"};
+    constexpr const char* STATION_MEASURES[]{"Idle", "Ready", "Unloading"};
+    constexpr const char* SITE_MEASURES[]{"Idle", "Mining"};
+
+    std::ofstream output(timestamp + "_Replications" + ".csv", std::ios::trunc);
+    output << "Entity,Measure,Mean,Variance,CI95Low,CI95High" << '\n';
+    output << std::fixed << std::setprecision(3);
+
+    const auto count = static_cast<double>(_numReplications);
+    const auto halfWidthFactor = tCritical95(_numReplications - 1) / std::sqrt(count);
+    auto writeRows = [&](const char* prefix,
+                         int entity,
+                         const auto& accumulators,
+                         const auto& measures) {
+        auto name = genMinionName(prefix, entity);
+        for (std::size_t measure = 0; measure < accumulators.size(); ++measure) {
+            auto sum = static_cast<double>(accumulators[measure].sum[entity]);
+            auto sumOfSquares = static_cast<double>(accumulators[measure].sumOfSquares[entity]);
+            auto mean = sum / count * TICK_DURATION;
+            auto variance = std::max(0.0, (sumOfSquares - sum * sum / count) / (count - 1))
+                            * TICK_DURATION * TICK_DURATION;
+            auto halfWidth = halfWidthFactor * std::sqrt(variance);
+            output << name << "," << measures[measure] << "," << mean << "," << variance << ","
+                   << (mean - halfWidth) << "," << (mean + halfWidth) << '\n';
+        }
+    };
+
+    for (auto truck = 0; truck < _numTrucks; ++truck) {
+        writeRows(TRUCK_PREFIX, truck, _truckTimes, TRUCK_MEASURES);
+    }
+    for (auto station = 0; station < _numStations; ++station) {
+        writeRows(STATION_PREFIX, station, _stationTimes, STATION_MEASURES);
+    }
+    for (auto site = 0; site < _numSites; ++site) {
+        writeRows(SITE_PREFIX, site, _siteTimes, SITE_MEASURES);
+    }
+}
+
+/// Runs every replication unthrottled, as many at a time as there are workers
+/// \param workerPool
+void MineReplications::run(MineWorkerPool& workerPool) {
+    std::ostringstream oss;
+    oss << "Running " << _numReplications << " replications on " << workerPool.size()
+        << " workers";
+    MineLogger::getInstance().logMessage(oss.str());
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<int> nextReplication{0};
+    workerPool.run([&](int) {
+        for (auto replication = nextReplication++; replication < _numReplications;
+             replication = nextReplication++) {
+            auto span = MineTraceSpan("replication");
+            auto fleet = TruckFleet(_numTrucks, _numStations, _numSites, _baseSeed + replication);
+            fleet.startTrucksAtMines();
+            auto pacer = MinePacer(0);
+            fleet.run(pacer);
+            accumulate(fleet);
+        }
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    oss.str("");
+    oss << std::fixed << std::setprecision(3) << "Ran " << _numReplications
+        << " replications in " << elapsed.count() << " s";
+    MineLogger::getInstance().logMessage(oss.str());
+}
+}  // namespace acme
\ No newline at end of file
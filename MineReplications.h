@@ -0,0 +1,59 @@
+/// \file   MineReplications.h
+/// \brief  Monte Carlo batch of independently seeded simulation days
+#pragma once
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace acme {
+class MineWorkerPool;
+class TruckFleet;
+
+/// \class  MineReplications
+/// \brief  Runs many simulation days with different random durations and summarises each
+///         truck, station and site statistic as a mean, a variance and a 95% confidence interval
+/// \note   Replication r is a single-threaded TruckFleet seeded with baseSeed + r, and the workers
+///         take the replications in turn. Times are whole ticks, so the sums and sums of squares
+///         are exact integers and the summary does not depend on the number of workers.
+class MineReplications {
+public:
+    ///
+    MineReplications(
+        int numTrucks,
+        int numStations,
+        int numReplications,
+        std::uint64_t baseSeed);
+
+    MineReplications() = delete;
+    MineReplications(const MineReplications&) = delete;
+    MineReplications& operator=(const MineReplications&) = delete;
+
+    ///
+    void outputSummary(const std::string& timestamp) const;
+
+    ///
+    void run(MineWorkerPool& workerPool);
+
+private:
+    /// Running sums of one statistic, per entity
+    struct Accumulator {
+        std::vector<std::int64_t> sum;
+        std::vector<std::int64_t> sumOfSquares;
+    };
+
+    void accumulate(const TruckFleet& fleet);
+
+    int _numTrucks;
+    int _numStations;
+    int _numSites;
+    int _numReplications;
+    std::uint64_t _baseSeed;
+
+    std::mutex _mutex;
+    std::array<Accumulator, 5> _truckTimes;
+    std::array<Accumulator, 3> _stationTimes;
+    std::array<Accumulator, 2> _siteTimes;
+};
+}  // namespace acme
\ No newline at end of file
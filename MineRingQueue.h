@@ -0,0 +1,73 @@
+/// \file   MineRingQueue.h
+/// \brief  FIFO queue over a single contiguous, growable ring buffer
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace acme {
+/// \class  MineRingQueue
+/// \brief  std::queue replacement that keeps its elements in one allocation, and never frees it
+template <typename T>
+class MineRingQueue {
+public:
+    MineRingQueue() = default;
+
+    /// Returns the element at a position counted from the front of the queue
+    const T& operator[](std::size_t position) const {
+        assert(position < _size);
+        return _buffer[(_head + position) & (_buffer.size() - 1)];
+    }
+
+    ///
+    bool empty() const {
+        return _size == 0;
+    }
+
+    ///
+    const T& front() const {
+        assert(_size != 0);
+        return _buffer[_head];
+    }
+
+    /// Removes and returns the element at the front of the queue
+    T pop() {
+        assert(_size != 0);
+        auto element = _buffer[_head];
+        _head = (_head + 1) & (_buffer.size() - 1);
+        --_size;
+        return element;
+    }
+
+    ///
+    void push(const T& element) {
+        if (_size == _buffer.size()) {
+            grow();
+        }
+        _buffer[(_head + _size) & (_buffer.size() - 1)] = element;
+        ++_size;
+    }
+
+    ///
+    std::size_t size() const {
+        return _size;
+    }
+
+private:
+    /// Doubles the capacity, unwrapping the elements to the start of the new buffer
+    void grow() {
+        std::vector<T> buffer(_buffer.empty() ? INITIAL_CAPACITY : _buffer.size() * 2);
+        for (std::size_t element = 0; element < _size; ++element) {
+            buffer[element] = _buffer[(_head + element) & (_buffer.size() - 1)];
+        }
+        _buffer.swap(buffer);
+        _head = 0;
+    }
+
+    static constexpr std::size_t INITIAL_CAPACITY = 4;  // Must be a power of two
+
+    std::vector<T> _buffer;
+    std::size_t _head{0};
+    std::size_t _size{0};
+};
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,45 @@
+/// \file   MineSetupMeter.cpp
+#include "MineSetupMeter.h"
+
+#include "MineLogger.h"
+
+#include <iomanip>
+#include <sstream>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define ACME_HAVE_MALLINFO2 1
+#endif
+
+namespace acme {
+///
+MineSetupMeter::MineSetupMeter()
+    : _start(Clock::now())
+    , _heapInUse(getHeapInUse()) {}
+
+///
+std::size_t MineSetupMeter::getHeapInUse() {
+#ifdef ACME_HAVE_MALLINFO2
+    auto info = mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+/// \param kind
+/// \param count
+void MineSetupMeter::report(const char* kind, int count) {
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - _start;
+    auto heapInUse = getHeapInUse();
+    auto bytes = heapInUse > _heapInUse ? heapInUse - _heapInUse : 0;
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << "Set up " << count << " " << kind << " in "
+        << elapsed.count() << " ms, " << (count != 0 ? bytes / count : 0) << " heap bytes each";
+    MineLogger::getInstance().logMessage(oss.str());
+
+    _start = Clock::now();
+    _heapInUse = getHeapInUse();
+}
+}  // namespace acme
\ No newline at end of file
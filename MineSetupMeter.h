@@ -0,0 +1,28 @@
+/// \file   MineSetupMeter.h
+/// \brief  Measures how long setting up the simulation takes, and how much memory it uses
+#pragma once
+#include <chrono>
+#include <cstddef>
+
+namespace acme {
+/// \class  MineSetupMeter
+/// \brief  Logs the time and heap bytes per entity of each setup step since the previous one
+/// \note   Heap usage comes from mallinfo2 where glibc provides it, and reads as 0 elsewhere
+class MineSetupMeter {
+public:
+    ///
+    MineSetupMeter();
+
+    /// Returns the bytes currently allocated from the heap
+    static std::size_t getHeapInUse();
+
+    /// Logs a setup step that created count entities of a kind, then starts measuring the next one
+    void report(const char* kind, int count);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Clock::time_point _start;
+    std::size_t _heapInUse;
+};
+}  // namespace acme
\ No newline at end of file
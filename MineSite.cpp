@@ -2,58 +2,71 @@
 /// \brief  Represents an H3 mining site
 #include "MineSite.h"
 
-#include "MineTimer.h"
+#include "MineStatsSink.h"
 
-#include <fstream>
+#include <algorithm>
 
 namespace acme {
-bool MineSite::_initial = true;
 ///
 /// \param name
-MineSite::MineSite(const std::string& name)
+/// \param siteId
+/// \param seed
+MineSite::MineSite(const std::string& name, int siteId, std::uint64_t seed)
     : _siteName(name)
-    , _timer(new MineTimer(H3_MINING_MIN, H3_MINING_MAX))
-    , _duration((*_timer)()) {}
+    , _id(siteId)
+    , _timer(H3_MINING_MIN, H3_MINING_MAX, seed, siteId)
+    , _duration(_timer()) {}
+
+/// Nothing to do; the ticks are accounted for when the flag changes, or by update()
+void MineSite::advance(int /*ticks*/) {}
+
+/// Returns the ticks accounted for as idle so far
+int MineSite::getIdleCount() const {
+    return _idleCount;
+}
+
+/// Returns the ticks accounted for as mined so far
+int MineSite::getMiningCount() const {
+    return _miningCount;
+}
 
 /// Returns a random mining time for this visit
 int MineSite::getMiningDuration() {
-    _duration = (*_timer)();
+    _duration = _timer();
     return _duration;
 }
 
+///
+int MineSite::getId() const {
+    return _id;
+}
+
 /// Returns the mine's name
 std::string MineSite::getName() const {
     return _siteName;
 }
 
 /// Outputs MineSite statistics
-/// \param timestamp
-void MineSite::outputStatistics(const std::string& timestamp) {
-    std::string mineSiteOutput(timestamp + "_MineSite" + ".csv");
-    std::ofstream siteOutput(mineSiteOutput, std::ios::app);
-
-    if (MineSite::_initial) {
-        siteOutput << "Mine,Idle,Mining" << std::endl;
-        MineSite::_initial = false;
-    }
-
-    siteOutput << getName() << "," << (_idleCount * TICK_DURATION) << ","
-               << (_miningCount * TICK_DURATION) << std::endl;
+/// \param stats
+void MineSite::outputStatistics(MineStatsSink& stats) {
+    stats.addSite(_id, _idleCount, _miningCount);
 }
 
-/// Set if a MineTruck is mining
-void MineSite::setMiningFlag(bool beingMined) {
+/// Sets whether a MineTruck is mining, from this tick on, accumulating the ticks spent with the
+/// old value; changes made while setting up, before the first tick, count from the first tick
+/// \param beingMined
+/// \param now
+void MineSite::setMiningFlag(bool beingMined, SimTime now) {
+    now = std::max(now, 0);
+    (_beingMined ? _miningCount : _idleCount) += now - _flagChanged;
+    _flagChanged = now;
     _beingMined = beingMined;
 }
 
-///
-/// \param timestamp
-void MineSite::update(const std::string& timestamp) {
-    _timestamp = timestamp;
-    if (_beingMined) {
-        ++_miningCount;
-    } else {
-        ++_idleCount;
-    }
-};
+/// Accounts for every tick up to and including this one
+/// \param now
+void MineSite::update(SimTime now) {
+    (_beingMined ? _miningCount : _idleCount) += now + 1 - _flagChanged;
+    _flagChanged = now + 1;
+}
 }  // namespace acme
\ No newline at end of file
@@ -2,44 +2,58 @@
 /// \brief  Represents an H3 mining site
 #pragma once
 #include "MineOverlord.h"
+#include "MineTimer.h"
 
-#include <memory>
+#include <cstdint>
 #include <string>
 
 namespace acme {
-class MineTimer;
 /// \class  MineSite
+/// \note   The idle and mining ticks are accumulated when the mining flag changes, so a MineSite
+///         needs no update on the ticks in between
 class MineSite : public MineMinion {
 public:
-    ///
-    explicit MineSite(const std::string& name);
+    /// Constructor; mining times are drawn from the seed's stream for this site id
+    explicit MineSite(const std::string& name, int siteId = 0, std::uint64_t seed = 0);
 
     MineSite() = delete;
     ~MineSite() override = default;
 
+    /// Nothing to do; the ticks are accounted for when the flag changes, or by update()
+    void advance(int ticks) override;
+
+    /// Returns the ticks accounted for as idle so far
+    int getIdleCount() const;
+
+    /// Returns the ticks accounted for as mined so far
+    int getMiningCount() const;
+
     ///
     int getMiningDuration();
 
     ///
-    std::string getName() const override;
+    int getId() const override;
 
     ///
-    void outputStatistics(const std::string& timestamp) override;
+    std::string getName() const override;
 
     ///
-    void setMiningFlag(bool beingMined);
+    void outputStatistics(MineStatsSink& stats) override;
 
-    ///
-    void update(const std::string& timestamp) override;
+    /// Sets whether a MineTruck is mining, from this tick on
+    void setMiningFlag(bool beingMined, SimTime now);
+
+    /// Accounts for every tick up to and including this one
+    void update(SimTime now) override;
 
 private:
-    static bool _initial;
     std::string _siteName;
-    std::string _timestamp;
-    std::unique_ptr<MineTimer> _timer;
+    int _id;
+    MineTimer _timer;
 
     int _duration{0};
     bool _beingMined{false};
+    SimTime _flagChanged{0};  // First tick not yet accounted for
     int _miningCount{0};
     int _idleCount{0};
 };
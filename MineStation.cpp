@@ -1,39 +1,47 @@
 /// \file   MineStation.cpp
 #include "MineStation.h"
 
+#include "MineDispatchers.h"
+#include "MineJournal.h"
+#include "MineMetrics.h"
+#include "MineStatsSink.h"
 #include "MineTruck.h"
 
-#include <fstream>
 #include <iostream>
 
 namespace acme {
-bool MineStation::_initial = true;
-
 ///
 /// \param name
-MineStation::MineStation(const std::string& name)
-    : _stationName(name) {
-    _stationStates[StationState::IDLE] = std::make_shared<MineStationIdle>(*this);
-    _stationStates[StationState::READY] = std::make_shared<MineStationReady>(*this);
-    _stationStates[StationState::UNLOADING] = std::make_shared<MineStationUnloading>(*this);
-
+/// \param id
+MineStation::MineStation(const std::string& name, int id)
+    : _stationName(name)
+    , _id(id) {
     // Initial state is IDLE
-    _currentState = _stationStates[StationState::IDLE].get();
+    _currentState = &_idle;
+}
+
+/// Accounts for ticks that elapsed without an update; the current MineStationState counts them
+/// down
+/// \param ticks
+void MineStation::advance(int ticks) {
+    _currentState->advance(ticks);
+    _now += ticks;
 }
 
-/// Removes a MineTruck from the queue
+/// Removes a MineTruck from the queue, which may bring a waiting MineTruck to the front
 MineTruck* MineStation::dequeue() {
-    auto* mineTruck = _truckQueue.front();
-    _truckQueue.pop();
+    auto* mineTruck = _truckQueue.pop();
     --_placeInQueue;
+    wake();
     return mineTruck;
 }
 
-/// Places a MineTruck on the queue
+/// Places a MineTruck on the queue, which wakes an IDLE MineStation
 /// \param mineTruck
 int MineStation::enqueue(MineTruck* mineTruck) {
     _truckQueue.push(mineTruck);
     ++_placeInQueue;
+    wake();
     return _placeInQueue;
 }
 
@@ -47,47 +55,78 @@ std::size_t MineStation::getQueueSize() const {
     return _truckQueue.size();
 }
 
+///
+int MineStation::getId() const {
+    return _id;
+}
+
 ///
 std::string MineStation::getName() const {
     return _stationName;
 }
 
+/// Gets the ticks remaining before the current MineStationState expires
+int MineStation::getRemainingDuration() const {
+    return _currentState->getDuration();
+}
+
 ///
 StationState MineStation::getState() const {
     return _currentState->getState();
 }
 
-/// Outputs MineSite stats; delegates to MineStationState classes
-/// \param timestamp
-void MineStation::outputStatistics(const std::string& timestamp) {
-    std::string mineStationOutput(timestamp + "_MineStation" + ".csv");
-    std::ofstream stationOutput(mineStationOutput, std::ios::app);
-
-    if (MineStation::_initial) {
-        stationOutput << "Station,Idle,Ready,Unloading" << std::endl;
-        MineStation::_initial = false;
+/// Gets the ticks spent in a MineStationState, up to the tick accounted for
+/// \param stationState
+int MineStation::getTimeInState(StationState stationState) const {
+    auto ticks = _timeInState[index(stationState)];
+    if (stationState == getState()) {
+        ticks += _now - _entered;
     }
-
-    stationOutput << getName() << ",";
-    _stationStates[StationState::IDLE]->outputStatistics(stationOutput);
-    stationOutput << ",";
-    _stationStates[StationState::READY]->outputStatistics(stationOutput);
-    stationOutput << ",";
-    _stationStates[StationState::UNLOADING]->outputStatistics(stationOutput);
-    stationOutput << std::endl;
+    return ticks;
 }
 
 ///
-/// \param truckState
-void MineStation::setStationState(StationState truckState) {
-    _currentState = _stationStates[truckState].get();
+bool MineStation::isTruckWaiting() const {
+    return !_truckQueue.empty() && _truckQueue.front()->getTruckState() == TruckState::QUEUED;
+}
+
+/// Outputs MineStation stats, the time spent in each MineStationState
+/// \param stats
+void MineStation::outputStatistics(MineStatsSink& stats) {
+    stats.addStation(
+        _id,
+        {getTimeInState(StationState::IDLE),
+         getTimeInState(StationState::READY),
+         getTimeInState(StationState::UNLOADING)});
+}
+
+/// Leaves the current MineStationState, accumulating the ticks spent in it, and enters another one
+/// \param stationState
+void MineStation::setStationState(StationState stationState) {
+    _timeInState[index(getState())] += _now - _entered;
+    _entered = _now;
+
+    MineMetrics::getInstance().countTransition(stationState);
+    _currentState = _stationStates[index(stationState)];
     _currentState->enterState();
+
+    if (auto* journal = MineRegistry::getInstance().getJournal()) {
+        journal->enterState(_now, _id, stationState);
+    }
 }
 
-///
-/// \param timestamp
-void MineStation::update(const std::string& timestamp) {
-    _timestamp = timestamp;
-    _currentState->update(_timestamp);
-};
+/// Accounts for the ticks since the previous update, then updates the current MineStationState
+/// \param now
+void MineStation::update(SimTime now) {
+    advance(now - _now - 1);
+    _now = now;
+    _currentState->update(now);
+}
+
+/// Asks the MineStationWaker, if there is one, to update the MineStation on the current tick
+void MineStation::wake() {
+    if (auto* waker = MineRegistry::getInstance().getStationWaker()) {
+        waker->wakeStation(*this);
+    }
+}
 }  // namespace acme
\ No newline at end of file
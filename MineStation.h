@@ -1,23 +1,44 @@
 /// \file   MineStation.h
 #pragma once
 #include "MineOverlord.h"
+#include "MineRingQueue.h"
 #include "MineStationState.h"
 
-#include <queue>
+#include <array>
 #include <string>
 
 namespace acme {
 class MineTruck;
 
+/// \class  MineStationWaker
+/// \brief  Told when a MineStation may be able to change state, so that it can sleep until then
+class MineStationWaker {
+public:
+    ///
+    virtual ~MineStationWaker() = default;
+
+    /// Has the MineStation updated on the current tick, once the MineTrucks have been updated
+    virtual void wakeStation(MineStation& mineStation) = 0;
+};
+
 /// \class  MineStation
+/// \note   A MineStation only changes state when its unloading ends, when a MineTruck joins or
+///         leaves its queue, or when a MineTruck reaches it; the last three wake it through the
+///         MineStationWaker in the MineRegistry, so it need not be updated on the ticks in between.
+///         The time in each MineStationState is accumulated when the state is left
 class MineStation : public MineMinion {
 public:
     ///
-    explicit MineStation(const std::string& name);
+    explicit MineStation(const std::string& name, int id = 0);
 
     MineStation() = delete;
+    MineStation(const MineStation&) = delete;
+    MineStation& operator=(const MineStation&) = delete;
     ~MineStation() override = default;
 
+    ///
+    void advance(int ticks) override;
+
     ///
     MineTruck* dequeue();
 
@@ -27,32 +48,55 @@ public:
     ///
     MineTruck* front();
 
+    ///
+    int getId() const override;
+
     ///
     std::string getName() const override;
 
     ///
     std::size_t getQueueSize() const;
 
+    ///
+    int getRemainingDuration() const;
+
     ///
     StationState getState() const;
 
+    /// Gets the ticks spent in a MineStationState, up to the tick accounted for
+    int getTimeInState(StationState) const;
+
+    /// True if the MineTruck at the front of the queue has reached the MineStation
+    bool isTruckWaiting() const;
+
     ///
-    void outputStatistics(const std::string& timestamp) override;
+    void outputStatistics(MineStatsSink& stats) override;
 
     ///
     void setStationState(StationState);
 
-    ///
-    void update(const std::string& timestamp) override;
+    /// Accounts for the ticks since the previous update, then updates the current MineStationState
+    void update(SimTime now) override;
+
+    /// Asks the MineStationWaker, if there is one, to update the MineStation on the current tick
+    void wake();
 
 private:
-    static bool _initial;
     std::string _stationName;
-    std::string _timestamp;
-    StationStateMap _stationStates;
+    int _id;
+
+    // Every state is stored inline, and looked up by StationState
+    MineStationIdle _idle{*this};
+    MineStationReady _ready{*this};
+    MineStationUnloading _unloading{*this};
+    const std::array<MineStationState*, NUM_STATION_STATES> _stationStates{
+        &_idle, &_ready, &_unloading};
 
     MineStationState* _currentState{nullptr};
-    std::queue<MineTruck*> _truckQueue;
+    MineRingQueue<MineTruck*> _truckQueue;
     int _placeInQueue{0};
+    std::array<int, NUM_STATION_STATES> _timeInState{};  // Of the states left so far
+    SimTime _entered{-1};                                // Tick the current state was entered at
+    SimTime _now{-1};                                    // Tick accounted for up to
 };
 }  // namespace acme
\ No newline at end of file
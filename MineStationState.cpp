@@ -1,14 +1,13 @@
 /// \file   MineStationState.cpp
 #include "MineStationState.h"
 
+#include "AcmeMinerUtils.h"
 #include "MineDefs.h"
 #include "MineDispatchers.h"
 #include "MineLogger.h"
 #include "MineStation.h"
 #include "MineTruck.h"
 
-#include <fstream>
-#include <sstream>
 
 namespace acme {
 ///
@@ -16,15 +15,23 @@ namespace acme {
 MineStationIdle::MineStationIdle(MineStation& context)
     : _context(context) {}
 
+/// Nothing to count down; IDLE lasts until a MineTruck joins the queue
+void MineStationIdle::advance(int /*ticks*/) {}
+
 /// Sets up conditions when the state is entered
 /// \param duration
 void MineStationIdle::enterState() {
     _duration = TICKS_PER_DAY;
 }
 
+/// Gets the ticks remaining before the state expires
+int MineStationIdle::getDuration() const {
+    return _duration;
+}
+
 ///
 StationState MineStationIdle::getNextState() const {
-    return StationState::READY;
+    return NEXT_STATION_STATE[index(getState())];
 }
 
 ///
@@ -34,17 +41,11 @@ StationState MineStationIdle::getState() const {
 
 /// Gets the text of the state name
 const char* MineStationIdle::getStateName() const {
-    return STATION_STATE_NAME[StationState::IDLE];
-}
-
-///
-void MineStationIdle::outputStatistics(std::ofstream& stationOutput) {
-    stationOutput << (_timeInState * TICK_DURATION);
+    return STATION_STATE_NAME[index(StationState::IDLE)];
 }
 
-/// Updates the state with the context
-void MineStationIdle::update(const std::string& timestamp) {
-    ++_timeInState;
+/// Updates the state with the context, once a MineTruck has joined the queue
+void MineStationIdle::update(SimTime now) {
     if (_context.getQueueSize() != 0) {
         _context.setStationState(getNextState());
     }
@@ -55,15 +56,23 @@ void MineStationIdle::update(const std::string& timestamp) {
 MineStationReady::MineStationReady(MineStation& context)
     : _context(context) {}
 
+/// Nothing to count down; READY lasts until a MineTruck reaches the front of the queue
+void MineStationReady::advance(int /*ticks*/) {}
+
 /// Sets up conditions when the state is entered
 /// \param duration
 void MineStationReady::enterState() {
     _duration = TRUCK_TRANSIT_TIME;
 }
 
+/// Gets the ticks remaining before the state expires
+int MineStationReady::getDuration() const {
+    return _duration;
+}
+
 ///
 StationState MineStationReady::getNextState() const {
-    return StationState::UNLOADING;
+    return NEXT_STATION_STATE[index(getState())];
 }
 
 ///
@@ -73,27 +82,18 @@ StationState MineStationReady::getState() const {
 
 /// Gets the text of the state name
 const char* MineStationReady::getStateName() const {
-    return STATION_STATE_NAME[StationState::READY];
-}
-
-///
-void MineStationReady::outputStatistics(std::ofstream& stationOutput) {
-    stationOutput << (_timeInState * TICK_DURATION);
-}
-
-/// Updates the state with the context
-void MineStationReady::update(const std::string& timestamp) {
-    ++_timeInState;
-
-    bool queued =
-        ((_context.getQueueSize() != 0)
-         && (_context.front()->getTruckState() == TruckState::QUEUED));
-
-    if (queued) {
-        std::ostringstream oss;
-        oss << timestamp << " : Station ";
-        oss << _context.getName() << " READY     with " << _context.getQueueSize() << " in queue";
-        MineLogger::getInstance().logMessage(oss.str());
+    return STATION_STATE_NAME[index(StationState::READY)];
+}
+
+/// Updates the state with the context, once a MineTruck may have reached the front of the queue
+void MineStationReady::update(SimTime now) {
+    if (_context.isTruckWaiting()) {
+        ACME_LOG(
+            INFO,
+            STATION,
+            _context.getId(),
+            tickToTimestamp(now) << " : Station " << _context.getName() << " READY     with "
+                                 << _context.getQueueSize() << " in queue");
         _context.setStationState(getNextState());
     }
 }
@@ -103,15 +103,26 @@ void MineStationReady::update(const std::string& timestamp) {
 MineStationUnloading::MineStationUnloading(MineStation& context)
     : _context(context) {}
 
+/// Counts down the ticks that elapsed without an update
+/// \param ticks
+void MineStationUnloading::advance(int ticks) {
+    _duration -= ticks;
+}
+
 /// Sets up conditions when the state is entered
 /// \param duration
 void MineStationUnloading::enterState() {
     _duration = TRUCK_UNLOADING_TIME;
 }
 
+/// Gets the ticks remaining before the state expires
+int MineStationUnloading::getDuration() const {
+    return _duration;
+}
+
 ///
 StationState MineStationUnloading::getNextState() const {
-    return StationState::READY;
+    return NEXT_STATION_STATE[index(getState())];
 }
 
 ///
@@ -121,25 +132,21 @@ StationState MineStationUnloading::getState() const {
 
 /// Gets the text of the state name
 const char* MineStationUnloading::getStateName() const {
-    return STATION_STATE_NAME[StationState::UNLOADING];
-}
-
-///
-void MineStationUnloading::outputStatistics(std::ofstream& stationOutput) {
-    stationOutput << (_timeInState * TICK_DURATION);
+    return STATION_STATE_NAME[index(StationState::UNLOADING)];
 }
 
 /// Updates the state with the context
-void MineStationUnloading::update(const std::string& timestamp) {
-    ++_timeInState;
+void MineStationUnloading::update(SimTime now) {
     --_duration;
 
     if (_duration == 0) {
-        std::ostringstream oss;
-        oss << timestamp << " : Station ";
-        oss << _context.getName() << " UNLOADING " << _context.getName();
-        oss << ", " << _context.getQueueSize() << " left in queue";
-        MineLogger::getInstance().logMessage(oss.str());
+        ACME_LOG(
+            INFO,
+            STATION,
+            _context.getId(),
+            tickToTimestamp(now) << " : Station " << _context.getName() << " UNLOADING "
+                                 << _context.getName() << ", " << _context.getQueueSize()
+                                 << " left in queue");
         _context.setStationState(getNextState());
     }
 }
@@ -1,36 +1,46 @@
 /// \file   MineStationState.h
 #pragma once
-#include <iosfwd>
-#include <memory>
-#include <unordered_map>
+#include "MineDefs.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
 namespace acme {
 class MineStation;
 
 /// MineStation states
-enum class StationState { IDLE, READY, UNLOADING };
+enum class StationState : std::uint8_t { IDLE, READY, UNLOADING };
+
+constexpr std::size_t NUM_STATION_STATES = 3;
+
+/// Position of a StationState in per-state tables
+constexpr std::size_t index(StationState stationState) {
+    return static_cast<std::size_t>(stationState);
+}
 
 /// Enum to string mapping
-static std::unordered_map<StationState, const char*> STATION_STATE_NAME{
-    {StationState::IDLE, "IDLE"},
-    {StationState::READY, "READY"},
-    {StationState::UNLOADING, "UNLOADING"}};
+constexpr std::array<const char*, NUM_STATION_STATES> STATION_STATE_NAME{
+    "IDLE", "READY", "UNLOADING"};
+
+/// The StationState that follows each one when it expires; a MineStation never returns to IDLE
+constexpr std::array<StationState, NUM_STATION_STATES> NEXT_STATION_STATE{
+    StationState::READY, StationState::UNLOADING, StationState::READY};
 
 /// \class  MineStationState
 /// \brief  ABC for MineStation states
 class MineStationState {
 public:
     virtual ~MineStationState() = default;
+    virtual void advance(int ticks) = 0;
     virtual void enterState() = 0;
+    virtual int getDuration() const = 0;
     virtual StationState getNextState() const = 0;
     virtual StationState getState() const = 0;
     virtual const char* getStateName() const = 0;
-    virtual void outputStatistics(std::ofstream&) = 0;
-    virtual void update(const std::string&) = 0;
+    virtual void update(SimTime now) = 0;
 };
 
-using StationStateMap = std::unordered_map<StationState, std::shared_ptr<MineStationState>>;
-
 /// \class  MineStationIdle
 /// \brief  Concrete IDLE state
 class MineStationIdle : public MineStationState {
@@ -42,10 +52,16 @@ public:
     ///
     ~MineStationIdle() override = default;
 
+    /// Counts down the ticks that elapsed without an update
+    void advance(int ticks) override;
+
     /// Sets up conditions when the state is entered
     /// \param duration
     void enterState() override;
 
+    /// Gets the ticks remaining before the state expires
+    int getDuration() const override;
+
     ///
     StationState getNextState() const override;
 
@@ -56,15 +72,11 @@ public:
     const char* getStateName() const override;
 
     ///
-    void outputStatistics(std::ofstream&) override;
-
-    ///
-    void update(const std::string&) override;
+    void update(SimTime now) override;
 
 private:
     MineStation& _context;
     int _duration{0};
-    int _timeInState{0};
 };
 
 /// \class  MineStationReady
@@ -78,10 +90,16 @@ public:
     ///
     ~MineStationReady() override = default;
 
+    /// Counts down the ticks that elapsed without an update
+    void advance(int ticks) override;
+
     /// Sets up conditions when the state is entered
     /// \param duration
     void enterState() override;
 
+    /// Gets the ticks remaining before the state expires
+    int getDuration() const override;
+
     ///
     StationState getNextState() const override;
 
@@ -92,15 +110,11 @@ public:
     const char* getStateName() const override;
 
     ///
-    void outputStatistics(std::ofstream&) override;
-
-    ///
-    void update(const std::string&) override;
+    void update(SimTime now) override;
 
 private:
     MineStation& _context;
     int _duration{0};
-    int _timeInState{0};
 };
 
 /// \class  MineStationUnloading
@@ -114,10 +128,16 @@ public:
     ///
     ~MineStationUnloading() override = default;
 
+    /// Counts down the ticks that elapsed without an update
+    void advance(int ticks) override;
+
     /// Sets up conditions when the state is entered
     /// \param duration
     void enterState() override;
 
+    /// Gets the ticks remaining before the state expires
+    int getDuration() const override;
+
     ///
     StationState getNextState() const override;
 
@@ -128,14 +148,10 @@ public:
     const char* getStateName() const override;
 
     ///
-    void outputStatistics(std::ofstream&) override;
-
-    ///
-    void update(const std::string&) override;
+    void update(SimTime now) override;
 
 private:
     MineStation& _context;
     int _duration{0};
-    int _timeInState{0};
 };
 }  // namespace acme
\ No newline at end of file
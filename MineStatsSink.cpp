@@ -0,0 +1,250 @@
+/// \file   MineStatsSink.cpp
+#include "MineStatsSink.h"
+
+#include "AcmeMinerUtils.h"
+#include "MineDefs.h"
+#include "MineMetrics.h"
+#include "MineTrace.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <thread>
+#include <tuple>
+
+namespace acme {
+namespace {
+constexpr char TRUCK_PREFIX[]{"ATRK"};
+constexpr char STATION_PREFIX[]{"ASTN"};
+constexpr char SITE_PREFIX[]{"ASIT"};
+
+/// \class  CsvBuffer
+/// \brief  Formats CSV rows with to_chars into a large buffer, writing it out only when full
+class CsvBuffer {
+public:
+    ///
+    explicit CsvBuffer(std::ofstream& output)
+        : _output(output)
+        , _buffer(BUFFER_SIZE) {}
+
+    ///
+    ~CsvBuffer() {
+        flush();
+        _output.flush();
+    }
+
+    /// Appends a field; every field but the first in a row is preceded by a comma
+    void field(int value) {
+        _buffer[_size++] = ',';
+        auto result = std::to_chars(&_buffer[_size], &_buffer[0] + _buffer.size(), value);
+        _size = static_cast<std::size_t>(result.ptr - _buffer.data());
+    }
+
+    /// Appends a field with a standard MineMinion name
+    void field(const char* prefix, int serial) {
+        _buffer[_size++] = ',';
+        name(prefix, serial);
+    }
+
+    /// Appends a field with the number of minutes in a number of ticks
+    void minutes(int ticks) {
+        field(ticks * TICK_DURATION);
+    }
+
+    /// Starts a row with a standard MineMinion name, as genMinionName makes it
+    void name(const char* prefix, int serial) {
+        auto* end = formatMinionName(&_buffer[_size], prefix, serial);
+        _size = static_cast<std::size_t>(end - _buffer.data());
+    }
+
+    /// Ends a row, and writes out the buffer if another row might not fit in it
+    void newline() {
+        _buffer[_size++] = '\n';
+        if (_size + MAX_ROW > _buffer.size()) {
+            flush();
+        }
+    }
+
+    ///
+    void text(const char* string) {
+        auto length = std::strlen(string);
+        std::memcpy(&_buffer[_size], string, length);
+        _size += length;
+    }
+
+private:
+    void flush() {
+        _output.write(_buffer.data(), static_cast<std::streamsize>(_size));
+        MineMetrics::getInstance().addStatsBytes(_size);
+        _size = 0;
+    }
+
+    static constexpr std::size_t BUFFER_SIZE = 1 << 20;
+    static constexpr std::size_t MAX_ROW = 256;
+
+    std::ofstream& _output;
+    std::vector<char> _buffer;
+    std::size_t _size{0};
+};
+}  // namespace
+
+/// Creates the CSV files, so that they are opened only once
+/// \param timestamp
+MineCsvStatsSink::MineCsvStatsSink(const std::string& timestamp)
+    : _siteOutput(timestamp + "_MineSite" + ".csv", std::ios::trunc)
+    , _stationOutput(timestamp + "_MineStation" + ".csv", std::ios::trunc)
+    , _truckOutput(timestamp + "_MineTruck" + ".csv", std::ios::trunc)
+    , _visitOutput(timestamp + "_StationVisits" + ".csv", std::ios::trunc) {}
+
+///
+MineCsvStatsSink::~MineCsvStatsSink() {
+    close();
+}
+
+///
+/// \param site
+/// \param idleTicks
+/// \param miningTicks
+void MineCsvStatsSink::addSite(int site, int idleTicks, int miningTicks) {
+    _sites.push_back({site, idleTicks, miningTicks});
+}
+
+///
+/// \param station
+/// \param ticks
+void MineCsvStatsSink::addStation(int station, const StationTimes& ticks) {
+    _stations.push_back({station, ticks});
+}
+
+///
+/// \param truck
+/// \param station
+/// \param visits
+void MineCsvStatsSink::addStationVisits(int truck, int station, int visits) {
+    _visits.push_back({truck, station, visits});
+}
+
+///
+/// \param truck
+/// \param ticks
+void MineCsvStatsSink::addTruck(int truck, const TruckTimes& ticks) {
+    _trucks.push_back({truck, ticks});
+}
+
+/// Writes the four files side by side, the trucks' on the calling thread
+void MineCsvStatsSink::close() {
+    if (_closed) {
+        return;
+    }
+    _closed = true;
+
+    auto startWriter = [this](const char* threadName, void (MineCsvStatsSink::*write)()) {
+        return std::thread([this, threadName, write] {
+            MineTrace::getInstance().setThreadName(threadName);
+            (this->*write)();
+        });
+    };
+    auto siteWriter = startWriter("MineSite writer", &MineCsvStatsSink::writeSites);
+    auto stationWriter = startWriter("MineStation writer", &MineCsvStatsSink::writeStations);
+    auto visitWriter = startWriter("StationVisits writer", &MineCsvStatsSink::writeVisits);
+    writeTrucks();
+    siteWriter.join();
+    stationWriter.join();
+    visitWriter.join();
+}
+
+///
+void MineCsvStatsSink::writeSites() {
+    auto span = MineTraceSpan("writeSites");
+    CsvBuffer buffer(_siteOutput);
+    buffer.text("Mine,Idle,Mining\n");
+    for (const auto& row : _sites) {
+        buffer.name(SITE_PREFIX, row.site);
+        buffer.minutes(row.idleTicks);
+        buffer.minutes(row.miningTicks);
+        buffer.newline();
+    }
+}
+
+///
+void MineCsvStatsSink::writeStations() {
+    auto span = MineTraceSpan("writeStations");
+    CsvBuffer buffer(_stationOutput);
+    buffer.text("Station,Idle,Ready,Unloading\n");
+    for (const auto& row : _stations) {
+        buffer.name(STATION_PREFIX, row.station);
+        for (auto ticks : row.ticks) {
+            buffer.minutes(ticks);
+        }
+        buffer.newline();
+    }
+}
+
+///
+void MineCsvStatsSink::writeTrucks() {
+    auto span = MineTraceSpan("writeTrucks");
+    CsvBuffer buffer(_truckOutput);
+    buffer.text("Truck,Mining,Inbound,Queued,Unloading,Outbound\n");
+    for (const auto& row : _trucks) {
+        buffer.name(TRUCK_PREFIX, row.truck);
+        for (auto ticks : row.ticks) {
+            buffer.minutes(ticks);
+        }
+        buffer.newline();
+    }
+}
+
+/// Sorts the visits by truck, then station, and writes one row per pair with the total visits
+void MineCsvStatsSink::writeVisits() {
+    auto span = MineTraceSpan("writeVisits");
+    std::sort(_visits.begin(), _visits.end(), [](const VisitRow& lhs, const VisitRow& rhs) {
+        return std::tie(lhs.truck, lhs.station) < std::tie(rhs.truck, rhs.station);
+    });
+
+    CsvBuffer buffer(_visitOutput);
+    buffer.text("Truck,Site,Visits\n");
+    for (auto visit = _visits.begin(); visit != _visits.end();) {
+        auto visits = 0;
+        auto run = visit;
+        for (; run != _visits.end() && run->truck == visit->truck
+               && run->station == visit->station;
+             ++run) {
+            visits += run->visits;
+        }
+
+        buffer.name(TRUCK_PREFIX, visit->truck);
+        buffer.field(STATION_PREFIX, visit->station);
+        buffer.field(visits);
+        buffer.newline();
+        visit = run;
+    }
+}
+
+///
+void MineNullStatsSink::addSite(int, int, int) {
+    ++_numRows;
+}
+
+///
+void MineNullStatsSink::addStation(int, const StationTimes&) {
+    ++_numRows;
+}
+
+///
+void MineNullStatsSink::addStationVisits(int, int, int) {
+    ++_numRows;
+}
+
+///
+void MineNullStatsSink::addTruck(int, const TruckTimes&) {
+    ++_numRows;
+}
+
+///
+void MineNullStatsSink::close() {}
+
+///
+std::size_t MineNullStatsSink::getNumRows() const {
+    return _numRows;
+}
+}  // namespace acme
\ No newline at end of file
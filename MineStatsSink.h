@@ -0,0 +1,135 @@
+/// \file   MineStatsSink.h
+/// \brief  Destinations for the end-of-day statistics of trucks, stations and sites
+#pragma once
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace acme {
+/// Ticks spent in each TruckState, in TruckState order
+using TruckTimes = std::array<int, 5>;
+
+/// Ticks spent in each StationState, in StationState order
+using StationTimes = std::array<int, 3>;
+
+/// \class  MineStatsSink
+/// \brief  Receives the statistics of every truck, station and site, identified by serial number
+class MineStatsSink {
+public:
+    ///
+    virtual ~MineStatsSink() = default;
+
+    ///
+    virtual void addSite(int site, int idleTicks, int miningTicks) = 0;
+
+    ///
+    virtual void addStation(int station, const StationTimes& ticks) = 0;
+
+    /// Counts visits of a truck to a station; visits may be added in any order, and more than once
+    virtual void addStationVisits(int truck, int station, int visits) = 0;
+
+    ///
+    virtual void addTruck(int truck, const TruckTimes& ticks) = 0;
+
+    /// Completes the output; nothing may be added afterwards
+    virtual void close() = 0;
+};
+
+/// \class  MineCsvStatsSink
+/// \brief  Writes the MineTruck, MineStation, MineSite and StationVisits CSV files
+/// \note   Each file is opened once; rows are kept until close(), which formats every file in large
+///         buffers on its own thread, and writes each buffer with a single call
+class MineCsvStatsSink : public MineStatsSink {
+public:
+    /// Constructor; creates the files, named after the timestamp
+    explicit MineCsvStatsSink(const std::string& timestamp);
+
+    MineCsvStatsSink() = delete;
+    MineCsvStatsSink(const MineCsvStatsSink&) = delete;
+    MineCsvStatsSink& operator=(const MineCsvStatsSink&) = delete;
+
+    /// Closes the sink, if that has not been done yet
+    ~MineCsvStatsSink() override;
+
+    ///
+    void addSite(int site, int idleTicks, int miningTicks) override;
+
+    ///
+    void addStation(int station, const StationTimes& ticks) override;
+
+    ///
+    void addStationVisits(int truck, int station, int visits) override;
+
+    ///
+    void addTruck(int truck, const TruckTimes& ticks) override;
+
+    ///
+    void close() override;
+
+private:
+    struct SiteRow {
+        int site;
+        int idleTicks;
+        int miningTicks;
+    };
+
+    struct StationRow {
+        int station;
+        StationTimes ticks;
+    };
+
+    struct TruckRow {
+        int truck;
+        TruckTimes ticks;
+    };
+
+    struct VisitRow {
+        int truck;
+        int station;
+        int visits;
+    };
+
+    void writeSites();
+    void writeStations();
+    void writeTrucks();
+    void writeVisits();
+
+    std::ofstream _siteOutput;
+    std::ofstream _stationOutput;
+    std::ofstream _truckOutput;
+    std::ofstream _visitOutput;
+    std::vector<SiteRow> _sites;
+    std::vector<StationRow> _stations;
+    std::vector<TruckRow> _trucks;
+    std::vector<VisitRow> _visits;
+    bool _closed{false};
+};
+
+/// \class  MineNullStatsSink
+/// \brief  Discards the statistics, only counting them, so that benchmarks measure the simulation
+class MineNullStatsSink : public MineStatsSink {
+public:
+    ///
+    void addSite(int site, int idleTicks, int miningTicks) override;
+
+    ///
+    void addStation(int station, const StationTimes& ticks) override;
+
+    ///
+    void addStationVisits(int truck, int station, int visits) override;
+
+    ///
+    void addTruck(int truck, const TruckTimes& ticks) override;
+
+    ///
+    void close() override;
+
+    /// Number of rows added so far, of every kind
+    std::size_t getNumRows() const;
+
+private:
+    std::size_t _numRows{0};
+};
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,204 @@
+/// \file   MineSweep.cpp
+#include "MineSweep.h"
+
+#include "MineDefs.h"
+#include "MineLogger.h"
+#include "MinePacer.h"
+#include "MineTrace.h"
+#include "MineWorkerPool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+
+namespace acme {
+namespace {
+/// A worker's share of the days, longest first, on a cache line of its own
+struct alignas(64) WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::size_t> points;
+};
+
+/// Takes the longest day left in a queue
+/// \param queue
+/// \param point
+/// \return false if the queue is empty
+bool takeLongest(WorkerQueue& queue, std::size_t& point) {
+    std::lock_guard<std::mutex> lockGuard(queue.mutex);
+    if (queue.points.empty()) {
+        return false;
+    }
+    point = queue.points.front();
+    queue.points.pop_front();
+    return true;
+}
+}  // namespace
+
+///
+/// \param index
+int MineRange::operator[](int index) const {
+    return first + index * step;
+}
+
+///
+int MineRange::size() const {
+    return last < first ? 0 : (last - first) / step + 1;
+}
+
+/// Lists every point of the grid, counting through the ranges with the last one varying fastest
+/// \param grid
+/// \param seed
+MineSweep::MineSweep(const MineSweepGrid& grid, std::uint64_t seed)
+    : _seed(seed) {
+    const std::array<const MineRange*, 7> ranges{
+        &grid.trucks,
+        &grid.stations,
+        &grid.sites,
+        &grid.transitTime,
+        &grid.unloadingTime,
+        &grid.miningMin,
+        &grid.miningMax};
+    std::size_t numPoints = 1;
+    for (const auto* range : ranges) {
+        numPoints *= static_cast<std::size_t>(range->size());
+    }
+
+    std::array<int, 7> values{};
+    for (std::size_t index = 0; index < numPoints; ++index) {
+        auto rest = index;
+        for (auto range = ranges.size(); range-- > 0;) {
+            auto size = static_cast<std::size_t>(ranges[range]->size());
+            values[range] = (*ranges[range])[static_cast<int>(rest % size)];
+            rest /= size;
+        }
+
+        MineSweepPoint point{};
+        point.numTrucks = values[0];
+        point.numStations = values[1];
+        point.numSites = values[2] != 0 ? values[2] : values[0];
+        point.durations.transitTime = values[3];
+        point.durations.unloadingTime = values[4];
+        point.durations.miningMin = values[5];
+        point.durations.miningMax = values[6];
+        if (point.numSites >= point.numTrucks
+            && point.durations.miningMin <= point.durations.miningMax) {
+            _points.push_back(point);
+        }
+    }
+}
+
+///
+const std::vector<MineSweepPoint>& MineSweep::getPoints() const {
+    return _points;
+}
+
+///
+const std::vector<FleetSummary>& MineSweep::getSummaries() const {
+    return _summaries;
+}
+
+/// Writes one row per point, durations in minutes, ready to be pivoted into a heat map:
+/// Trucks,Stations,Sites,TransitTime,UnloadingTime,MiningMin,MiningMax,Deliveries,
+/// DeliveriesPerHour,MeanQueueWait,StationUtilization,SiteUtilization
+/// \param timestamp
+void MineSweep::outputSummary(const std::string& timestamp) const {
+    std::ofstream output(timestamp + "_Sweep" + ".csv", std::ios::trunc);
+    output << "Trucks,Stations,Sites,TransitTime,UnloadingTime,MiningMin,MiningMax,Deliveries,"
+              "DeliveriesPerHour,MeanQueueWait,StationUtilization,SiteUtilization"
+           << '\n';
+    output << std::fixed << std::setprecision(3);
+    for (std::size_t point = 0; point < _points.size(); ++point) {
+        const auto& parameters = _points[point];
+        const auto& durations = parameters.durations;
+        const auto& summary = _summaries[point];
+        output << parameters.numTrucks << "," << parameters.numStations << ","
+               << parameters.numSites << "," << (durations.transitTime * TICK_DURATION) << ","
+               << (durations.unloadingTime * TICK_DURATION) << ","
+               << (durations.miningMin * TICK_DURATION) << ","
+               << (durations.miningMax * TICK_DURATION) << "," << summary.deliveries << ","
+               << summary.getDeliveriesPerHour() << "," << summary.getMeanQueueWait() << ","
+               << summary.getStationUtilization() << "," << summary.getSiteUtilization() << '\n';
+    }
+}
+
+/// Deals the days out longest first, then every worker runs its own queue, and steals once it is
+/// empty. A day's cost is mostly its truck transitions, one per state of every trip, where a trip
+/// takes the mean mining time, two transits and an unloading; the countdown passes over every
+/// truck, station and site cost about as much again as ten transitions each, as measured on
+/// fleets of 200,000 trucks
+/// \param workerPool
+void MineSweep::run(MineWorkerPool& workerPool) {
+    std::ostringstream oss;
+    oss << "Sweeping " << _points.size() << " grid points on " << workerPool.size() << " workers";
+    MineLogger::getInstance().logMessage(oss.str());
+
+    auto cost = [this](std::size_t point) {
+        const auto& parameters = _points[point];
+        const auto& durations = parameters.durations;
+        auto trip = (durations.miningMin + durations.miningMax) / 2.0 + 2 * durations.transitTime
+                    + durations.unloadingTime;
+        auto numEntities = parameters.numTrucks + parameters.numStations + parameters.numSites;
+        return parameters.numTrucks * NUM_TRUCK_STATES * TICKS_PER_DAY / trip + 10.0 * numEntities;
+    };
+    std::vector<std::size_t> order(_points.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&cost](std::size_t lhs, std::size_t rhs) {
+        return cost(lhs) > cost(rhs);
+    });
+
+    const auto numWorkers = static_cast<std::size_t>(workerPool.size());
+    std::vector<WorkerQueue> queues(numWorkers);
+    for (std::size_t position = 0; position < order.size(); ++position) {
+        queues[position % numWorkers].points.push_back(order[position]);
+    }
+
+    _summaries.assign(_points.size(), FleetSummary{});
+    std::atomic<int> numStolen{0};
+    auto start = std::chrono::steady_clock::now();
+    workerPool.run([&](int worker) {
+        auto runDay = [this](std::size_t point) {
+            auto span = MineTraceSpan("sweepPoint");
+            const auto& parameters = _points[point];
+            auto fleet = TruckFleet(
+                parameters.numTrucks,
+                parameters.numStations,
+                parameters.numSites,
+                _seed,
+                parameters.durations);
+            fleet.startTrucksAtMines();
+            auto pacer = MinePacer(0);
+            fleet.run(pacer);
+            _summaries[point] = fleet.getSummary();
+        };
+
+        for (std::size_t point = 0;;) {
+            if (takeLongest(queues[worker], point)) {
+                runDay(point);
+                continue;
+            }
+            auto stolen = false;
+            for (std::size_t offset = 1; offset < numWorkers && !stolen; ++offset) {
+                stolen = takeLongest(queues[(worker + offset) % numWorkers], point);
+            }
+            if (!stolen) {
+                break;
+            }
+            ++numStolen;
+            runDay(point);
+        }
+    });
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    oss.str("");
+    oss << std::fixed << std::setprecision(3) << "Swept " << _points.size() << " grid points in "
+        << elapsed.count() << " s, " << numStolen << " of them stolen";
+    MineLogger::getInstance().logMessage(oss.str());
+}
+}  // namespace acme
\ No newline at end of file
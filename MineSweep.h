@@ -0,0 +1,82 @@
+/// \file   MineSweep.h
+/// \brief  Parallel parameter sweep of TruckFleet days over fleet sizes and durations
+#pragma once
+#include "TruckFleet.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace acme {
+class MineWorkerPool;
+
+/// \struct MineRange
+/// \brief  The values first, first + step, first + 2 * step, ..., up to last
+struct MineRange {
+    int first{0};
+    int last{0};
+    int step{1};
+
+    /// Returns the value at an index
+    int operator[](int index) const;
+
+    ///
+    int size() const;
+};
+
+/// \struct MineSweepGrid
+/// \brief  The values each parameter of a sweep takes, durations in ticks
+struct MineSweepGrid {
+    MineRange trucks;
+    MineRange stations;
+    MineRange sites;  // 0 mines one site per truck; there are never fewer sites than trucks
+    MineRange transitTime{TRUCK_TRANSIT_TIME, TRUCK_TRANSIT_TIME};
+    MineRange unloadingTime{TRUCK_UNLOADING_TIME, TRUCK_UNLOADING_TIME};
+    MineRange miningMin{H3_MINING_MIN, H3_MINING_MIN};
+    MineRange miningMax{H3_MINING_MAX, H3_MINING_MAX};
+};
+
+/// \struct MineSweepPoint
+/// \brief  One simulation day of a sweep
+struct MineSweepPoint {
+    int numTrucks;
+    int numStations;
+    int numSites;
+    FleetDurations durations;
+};
+
+/// \class  MineSweep
+/// \brief  Runs one TruckFleet day per point of a MineSweepGrid, and writes a summary row for each
+/// \note   Every day is seeded with the same seed, so the points differ only in their parameters.
+///         The days are dealt out longest first, round-robin, to one queue per worker; a worker
+///         whose queue is empty steals the longest day left in another's, so the workers finish
+///         together whatever the mix of sizes
+class MineSweep {
+public:
+    /// Constructor; skips the points with fewer sites than trucks, as every truck holds a site
+    /// while it mines and on its way back, and those whose shortest mining time exceeds the longest
+    MineSweep(const MineSweepGrid& grid, std::uint64_t seed);
+
+    MineSweep() = delete;
+    MineSweep(const MineSweep&) = delete;
+    MineSweep& operator=(const MineSweep&) = delete;
+
+    /// Returns the points, in grid order, with the number of trucks varying slowest
+    const std::vector<MineSweepPoint>& getPoints() const;
+
+    /// Returns the summary of each point's day, in the order of getPoints
+    const std::vector<FleetSummary>& getSummaries() const;
+
+    ///
+    void outputSummary(const std::string& timestamp) const;
+
+    /// Runs every day unthrottled, one per worker at a time
+    void run(MineWorkerPool& workerPool);
+
+private:
+    std::vector<MineSweepPoint> _points;
+    std::vector<FleetSummary> _summaries;
+    std::uint64_t _seed;
+};
+}  // namespace acme
\ No newline at end of file
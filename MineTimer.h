@@ -2,31 +2,47 @@
 #pragma once
 #include "MineDefs.h"
 
-#include <chrono>
-#include <iostream>
-#include <random>
+#include <cstdint>
 
 namespace acme {
 static constexpr int H3_MINING_MIN = 1 * TICKS_PER_HOUR;  // 1 hour = 12 ticks
 static constexpr int H3_MINING_MAX = 5 * TICKS_PER_HOUR;  // 5 hours = 60 ticks
 
 /// Generates random mining times
+/// \note   Counter-based: the n-th draw of a stream is a hash of (seed, stream, n), so a MineTimer
+///         is a few bytes, a run is replayed exactly from its seed, and streams used on different
+///         threads never interact. Each MineSite draws from its own stream, keyed by its site id.
 class MineTimer {
 public:
     ///
-    MineTimer(int min, int max)
-        : _generator(std::chrono::system_clock::now().time_since_epoch().count())
-        , _distribution(min, max) {}
+    MineTimer(int min, int max, std::uint64_t seed = 0, std::uint64_t stream = 0)
+        : _key(mix(mix(seed) + stream))
+        , _min(min)
+        , _range(static_cast<std::uint32_t>(max - min + 1)) {}
 
-    ///
+    /// Draws the time for the next visit
     int operator()() {
-        return _distribution(_generator);
+        auto bits = mix(_key + (std::uint64_t{++_visit} * GOLDEN_GAMMA));
+
+        // Multiply-shift maps the top 32 bits onto the range without a division
+        return _min + static_cast<int>(((bits >> 32) * _range) >> 32);
     }
 
     MineTimer() = delete;
 
 private:
-    std::mt19937 _generator;                           // Mersenne Twister RNG
-    std::uniform_int_distribution<int> _distribution;  // Uniform distribution
+    static constexpr std::uint64_t GOLDEN_GAMMA = 0x9e3779b97f4a7c15;
+
+    /// SplitMix64 finaliser
+    static constexpr std::uint64_t mix(std::uint64_t bits) {
+        bits = (bits ^ (bits >> 30)) * 0xbf58476d1ce4e5b9;
+        bits = (bits ^ (bits >> 27)) * 0x94d049bb133111eb;
+        return bits ^ (bits >> 31);
+    }
+
+    std::uint64_t _key;       // Hash of the seed and stream
+    std::uint32_t _visit{0};  // Draws so far
+    std::int32_t _min;
+    std::uint32_t _range;
 };
 }  // namespace acme
\ No newline at end of file
@@ -0,0 +1,144 @@
+/// \file   MineTimingWheel.h
+/// \brief  Hierarchical timing wheel that hands out the items due on each tick
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace acme {
+/// \class  MineTimingWheel
+/// \brief  Schedules items on future ticks, and collects those due on the current tick
+/// \note   Level L has 64 slots of 64^L ticks each; an item waits on the lowest level whose slot
+///         covers its tick, and drops a level whenever the wheel reaches that slot, so scheduling
+///         and collecting an item cost O(Levels) however many items are waiting. Each slot is a
+///         list through one pool of entries, which only grows when more items are waiting than
+///         ever before, so a steady state does not allocate
+template <typename T, std::size_t Levels = 4>
+class MineTimingWheel {
+public:
+    static_assert(Levels >= 1, "A timing wheel needs at least one level");
+
+    /// Constructor; the first tick collected is start
+    explicit MineTimingWheel(int start = 0)
+        : _now(start) {
+        assert(start >= 0);
+    }
+
+    /// Appends the items due on the current tick to due, in the order they were scheduled on their
+    /// final level, then moves on to the next tick
+    void collect(std::vector<T>& due) {
+        // Bring down the slots that begin on this tick, from the top level to the bottom one
+        for (auto level = Levels - 1; level != 0; --level) {
+            if ((_now & ((1 << (level * SLOT_BITS)) - 1)) == 0) {
+                auto& slot = _slots[level][slotOf(_now, level)];
+                auto entry = slot.head;
+                slot = {};
+                while (entry != NONE) {
+                    auto next = _entries[entry].next;
+                    place(entry);
+                    entry = next;
+                }
+            }
+        }
+
+        auto& slot = _slots[0][slotOf(_now, 0)];
+        auto entry = slot.head;
+        slot = {};
+        while (entry != NONE) {
+            assert(_entries[entry].tick == _now);
+            due.push_back(_entries[entry].item);
+            auto next = _entries[entry].next;
+            _entries[entry].next = _free;
+            _free = entry;
+            entry = next;
+            --_size;
+        }
+        ++_now;
+    }
+
+    ///
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /// The tick the next call to collect() hands out
+    int now() const {
+        return _now;
+    }
+
+    /// Makes room for this many items to wait at once without allocating
+    void reserve(std::size_t numItems) {
+        _entries.reserve(numItems);
+    }
+
+    /// Schedules an item on the current tick or a later one
+    void schedule(int tick, const T& item) {
+        assert(tick >= _now);
+        auto entry = _free;
+        if (entry != NONE) {
+            _free = _entries[entry].next;
+            _entries[entry] = {tick, item, NONE};
+        } else {
+            entry = static_cast<std::int32_t>(_entries.size());
+            _entries.push_back({tick, item, NONE});
+        }
+        place(entry);
+        ++_size;
+    }
+
+    ///
+    std::size_t size() const {
+        return _size;
+    }
+
+private:
+    static constexpr std::int32_t NONE = -1;
+
+    /// An item, and the next entry in its slot or in the free list
+    struct Entry {
+        int tick;
+        T item;
+        std::int32_t next;
+    };
+
+    /// The first and last entries waiting in a slot
+    struct Slot {
+        std::int32_t head{NONE};
+        std::int32_t tail{NONE};
+    };
+
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+
+    /// Appends an entry to its slot
+    void place(std::int32_t entry) {
+        // The lowest level on which the tick and the current tick share every higher digit
+        auto tick = _entries[entry].tick;
+        std::size_t level = 0;
+        while ((tick >> ((level + 1) * SLOT_BITS)) != (_now >> ((level + 1) * SLOT_BITS))) {
+            ++level;
+            assert(level < Levels && "tick is beyond the reach of the wheel");
+        }
+        auto& slot = _slots[level][slotOf(tick, level)];
+        _entries[entry].next = NONE;
+        if (slot.tail == NONE) {
+            slot.head = entry;
+        } else {
+            _entries[slot.tail].next = entry;
+        }
+        slot.tail = entry;
+    }
+
+    static std::size_t slotOf(int tick, std::size_t level) {
+        return static_cast<std::size_t>(tick >> (level * SLOT_BITS)) & (SLOTS - 1);
+    }
+
+    std::array<std::array<Slot, SLOTS>, Levels> _slots{};
+    std::vector<Entry> _entries;
+    std::int32_t _free{NONE};
+    std::size_t _size{0};
+    int _now;
+};
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,94 @@
+/// \file   MineTrace.cpp
+#include "MineTrace.h"
+
+#include <fstream>
+#include <iomanip>
+
+namespace acme {
+namespace {
+/// Microseconds, the unit of trace-event timestamps and durations
+double toMicros(MineTrace::Clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+}  // namespace
+
+///
+void MineTrace::enable() {
+    _start = Clock::now();
+    _enabled.store(true, std::memory_order_relaxed);
+}
+
+///
+std::size_t MineTrace::getNumSpans() const {
+    std::lock_guard<std::mutex> lockGuard(_mutex);
+    std::size_t numSpans = 0;
+    for (const auto& buffer : _buffers) {
+        std::lock_guard<std::mutex> bufferGuard(buffer->mutex);
+        numSpans += buffer->spans.size();
+    }
+    return numSpans;
+}
+
+/// Returns the calling thread's buffer, which is created on its first span or name
+MineTrace::ThreadBuffer& MineTrace::getThreadBuffer() {
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+    if (!threadBuffer) {
+        std::lock_guard<std::mutex> lockGuard(_mutex);
+        _buffers.push_back(std::make_unique<ThreadBuffer>());
+        threadBuffer = _buffers.back().get();
+        threadBuffer->tid = static_cast<int>(_buffers.size());
+    }
+    return *threadBuffer;
+}
+
+/// \param name
+/// \param start
+/// \param end
+void MineTrace::record(const char* name, Clock::time_point start, Clock::time_point end) {
+    auto& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lockGuard(buffer.mutex);
+    buffer.spans.push_back({name, start, end});
+}
+
+/// \param name
+void MineTrace::setThreadName(const std::string& name) {
+    if (!isEnabled()) {
+        return;
+    }
+    auto& buffer = getThreadBuffer();
+    std::lock_guard<std::mutex> lockGuard(buffer.mutex);
+    buffer.name = name;
+}
+
+/// Writes a thread_name metadata event per thread, then one complete ("X") event per span
+/// \param fileName
+void MineTrace::writeJson(const std::string& fileName) {
+    _enabled.store(false, std::memory_order_relaxed);
+
+    std::ofstream output(fileName, std::ios::trunc);
+    output << std::fixed << std::setprecision(3)
+           << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    auto first = true;
+    auto separate = [&output, &first]() {
+        output << (first ? "" : ",\n");
+        first = false;
+    };
+
+    std::lock_guard<std::mutex> lockGuard(_mutex);
+    for (const auto& buffer : _buffers) {
+        std::lock_guard<std::mutex> bufferGuard(buffer->mutex);
+        if (!buffer->name.empty()) {
+            separate();
+            output << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": "
+                   << buffer->tid << ", \"args\": {\"name\": \"" << buffer->name << "\"}}";
+        }
+        for (const auto& span : buffer->spans) {
+            separate();
+            output << "{\"name\": \"" << span.name << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                   << buffer->tid << ", \"ts\": " << toMicros(span.start - _start)
+                   << ", \"dur\": " << toMicros(span.end - span.start) << '}';
+        }
+    }
+    output << "\n]}\n";
+}
+}  // namespace acme
\ No newline at end of file
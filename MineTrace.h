@@ -0,0 +1,104 @@
+/// \file   MineTrace.h
+/// \brief  Opt-in timeline of scoped spans, exported as Chrome trace-event JSON
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace acme {
+/// \class  MineTrace
+/// \brief  Records the spans of every thread in a buffer of that thread's own, and writes them
+///         all as trace events that chrome://tracing and Perfetto can open
+/// \note   Until enable() is called, a span costs one relaxed load and a branch. Span names must
+///         be string literals, or otherwise outlive the trace
+class MineTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    ///
+    static MineTrace& getInstance() {
+        static MineTrace instance;
+        return instance;
+    }
+
+    /// True once enable() has been called, until the trace is written
+    static bool isEnabled() {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    MineTrace(const MineTrace&) = delete;
+    MineTrace& operator=(const MineTrace&) = delete;
+
+    /// Starts recording; timestamps are relative to this call
+    void enable();
+
+    /// Returns the number of spans recorded so far, on every thread
+    std::size_t getNumSpans() const;
+
+    /// Records a span of the calling thread
+    void record(const char* name, Clock::time_point start, Clock::time_point end);
+
+    /// Names the calling thread in the trace, if tracing is enabled
+    void setThreadName(const std::string& name);
+
+    /// Stops recording, and writes every span recorded so far
+    void writeJson(const std::string& fileName);
+
+private:
+    MineTrace() = default;
+    ~MineTrace() = default;
+
+    struct Span {
+        const char* name;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    /// The spans of one thread; the mutex is only contended while the trace is written
+    struct ThreadBuffer {
+        int tid;
+        std::string name;
+        std::mutex mutex;
+        std::vector<Span> spans;
+    };
+
+    ThreadBuffer& getThreadBuffer();
+
+    static inline std::atomic<bool> _enabled{false};
+
+    Clock::time_point _start;
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;  // Outlive their threads
+};
+
+/// \class  MineTraceSpan
+/// \brief  Records a span from its construction to its destruction, if tracing is enabled
+class MineTraceSpan {
+public:
+    ///
+    explicit MineTraceSpan(const char* name)
+        : _name(MineTrace::isEnabled() ? name : nullptr) {
+        if (_name) {
+            _start = MineTrace::Clock::now();
+        }
+    }
+
+    MineTraceSpan() = delete;
+    MineTraceSpan(const MineTraceSpan&) = delete;
+    MineTraceSpan& operator=(const MineTraceSpan&) = delete;
+
+    ///
+    ~MineTraceSpan() {
+        if (_name) {
+            MineTrace::getInstance().record(_name, _start, MineTrace::Clock::now());
+        }
+    }
+
+private:
+    const char* _name;
+    MineTrace::Clock::time_point _start;
+};
+}  // namespace acme
\ No newline at end of file
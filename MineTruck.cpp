@@ -1,33 +1,38 @@
 /// \file   MineTruck.cpp
 #include "MineTruck.h"
 
-#include <fstream>
-#include <iostream>
-#include <memory>
+#include "MineDispatchers.h"
+#include "MineJournal.h"
+#include "MineMetrics.h"
+#include "MineSite.h"
+#include "MineStatsSink.h"
 
-namespace acme {
-bool MineTruck::_initial = true;
-bool MineTruck::_revisited = true;
 
+namespace acme {
 ///
 /// \param name
-MineTruck::MineTruck(const std::string& name)
-    : _truckName(name) {
-    // Instantiate MineTruckStates
-    _truckStates[TruckState::MINING] = std::make_shared<MineTruckMining>(*this);
-    _truckStates[TruckState::INBOUND] = std::make_shared<MineTruckInbound>(*this);
-    _truckStates[TruckState::QUEUED] = std::make_shared<MineTruckQueued>(*this);
-    _truckStates[TruckState::UNLOADING] = std::make_shared<MineTruckUnloading>(*this);
-    _truckStates[TruckState::OUTBOUND] = std::make_shared<MineTruckOutbound>(*this);
-
+/// \param id
+MineTruck::MineTruck(const std::string& name, int id)
+    : _truckName(name)
+    , _id(id) {
     // Initial state is MINING
-    _currentState = _truckStates[TruckState::MINING].get();
+    _currentState = &_mining;
+}
+
+/// Accounts for ticks that elapsed without an update; the current MineTruckState counts them down
+/// \param ticks
+void MineTruck::advance(int ticks) {
+    _currentState->advance(ticks);
+    _now += ticks;
 }
 
 /// Assigns a MineSite
 /// \param mineSite
 void MineTruck::assignMineSite(MineSite* mineSite) {
     _mineSite = mineSite;
+    if (auto* journal = MineRegistry::getInstance().getJournal()) {
+        journal->dispatchToSite(_now, _id, mineSite->getId());
+    }
 }
 
 /// Assigns a MineStation
@@ -46,57 +51,62 @@ MineStation* MineTruck::getAssignedMineStation() const {
     return _mineStation;
 }
 
+///
+int MineTruck::getId() const {
+    return _id;
+}
+
 ///
 std::string MineTruck::getName() const {
     return _truckName;
 }
 
+///
+SimTime MineTruck::getNow() const {
+    return _now;
+}
+
 ///
 int MineTruck::getPlaceInQueue() const {
     return _placeInQueue;
 }
 
-TruckState MineTruck::getTruckState() const {
-    return _currentState->getState();
+/// Gets the ticks remaining before the current MineTruckState expires
+int MineTruck::getRemainingDuration() const {
+    return _currentState->getDuration();
 }
 
-/// Outputs stations visited for this MineTruck
-void MineTruck::outputStationVisits(const std::string& timestamp) {
-    std::string mineTruckOutput(timestamp + "_StationVisits" + ".csv");
-    std::ofstream truckOutput(mineTruckOutput, std::ios::app);
-
-    if (MineTruck::_revisited) {
-        truckOutput << "Truck,Site,Visits" << std::endl;
-        MineTruck::_revisited = false;
+/// Gets the ticks spent in a MineTruckState, up to the tick accounted for
+/// \param truckState
+int MineTruck::getTimeInState(TruckState truckState) const {
+    auto ticks = _timeInState[index(truckState)];
+    if (truckState == getTruckState()) {
+        ticks += _now - _entered;
     }
-
-    auto truckState = _truckStates[TruckState::INBOUND];
-    auto* inbound = static_cast<MineTruckInbound*>(truckState.get());
-    inbound->outputStationVisits(truckOutput);
+    return ticks;
 }
 
-/// Outputs MineTruck stats; delegates to MineTruckState classes
-/// \param timestamp
-void MineTruck::outputStatistics(const std::string& timestamp) {
-    std::string mineTruckOutput(timestamp + "_MineTruck" + ".csv");
-    std::ofstream truckOutput(mineTruckOutput, std::ios::app);
+///
+TruckState MineTruck::getTruckState() const {
+    return _currentState->getState();
+}
 
-    if (MineTruck::_initial) {
-        truckOutput << "Truck,Mining,Inbound,Queued,Unloading,Outbound" << std::endl;
-        MineTruck::_initial = false;
-    }
+/// Outputs stations visited for this MineTruck
+/// \param stats
+void MineTruck::outputStationVisits(MineStatsSink& stats) {
+    _inbound.outputStationVisits(stats);
+}
 
-    truckOutput << getName() << ",";
-    _truckStates[TruckState::MINING]->outputStatistics(truckOutput);
-    truckOutput << ",";
-    _truckStates[TruckState::INBOUND]->outputStatistics(truckOutput);
-    truckOutput << ",";
-    _truckStates[TruckState::QUEUED]->outputStatistics(truckOutput);
-    truckOutput << ",";
-    _truckStates[TruckState::UNLOADING]->outputStatistics(truckOutput);
-    truckOutput << ",";
-    _truckStates[TruckState::OUTBOUND]->outputStatistics(truckOutput);
-    truckOutput << std::endl;
+/// Outputs MineTruck stats, the time spent in each MineTruckState
+/// \param stats
+void MineTruck::outputStatistics(MineStatsSink& stats) {
+    stats.addTruck(
+        _id,
+        {getTimeInState(TruckState::MINING),
+         getTimeInState(TruckState::INBOUND),
+         getTimeInState(TruckState::QUEUED),
+         getTimeInState(TruckState::UNLOADING),
+         getTimeInState(TruckState::OUTBOUND)});
 }
 
 ///
@@ -105,17 +115,28 @@ void MineTruck::setPlaceInQueue(int placeInQueue) {
     _placeInQueue = placeInQueue;
 }
 
-///
+/// Leaves the current MineTruckState, accumulating the ticks spent in it, and enters another one
 /// \param truckState
 void MineTruck::setTruckState(TruckState truckState) {
-    _currentState = _truckStates[truckState].get();
+    _timeInState[index(getTruckState())] += _now - _entered;
+    _entered = _now;
+
+    MineMetrics::getInstance().countTransition(truckState);
+    _currentState = _truckStates[index(truckState)];
     _currentState->enterState();
+
+    if (auto* journal = MineRegistry::getInstance().getJournal()) {
+        journal->enterState(_now, _id, truckState);
+        if (truckState == TruckState::INBOUND) {
+            journal->dispatchToStation(_now, _id, _mineStation->getId(), _placeInQueue);
+        }
+    }
 }
 
 ///
-/// \param timestamp
-void MineTruck::update(const std::string& timestamp) {
-    _timestamp = timestamp;
-    _currentState->update(_timestamp);
-};
+/// \param now
+void MineTruck::update(SimTime now) {
+    _now = now;
+    _currentState->update(now);
+}
 }  // namespace acme
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "MineOverlord.h"
 #include "MineTruckStates.h"
 
+#include <array>
 #include <string>
 
 namespace acme {
@@ -10,14 +11,21 @@ class MineSite;
 class MineStation;
 
 /// \class  MineTruck
+/// \note   The time in each MineTruckState is accumulated when the state is left, from the ticks
+///         it was entered and left at, rather than counted tick by tick
 class MineTruck : public MineMinion {
 public:
     ///
-    explicit MineTruck(const std::string& name);
+    explicit MineTruck(const std::string& name, int id = 0);
 
     MineTruck() = delete;
+    MineTruck(const MineTruck&) = delete;
+    MineTruck& operator=(const MineTruck&) = delete;
     ~MineTruck() override = default;
 
+    ///
+    void advance(int ticks) override;
+
     ///
     void assignMineSite(MineSite*);
 
@@ -30,20 +38,32 @@ public:
     ///
     MineStation* getAssignedMineStation() const;
 
+    ///
+    int getId() const override;
+
     ///
     std::string getName() const override;
 
+    /// The tick the MineTruck has been accounted for up to
+    SimTime getNow() const;
+
     ///
     int getPlaceInQueue() const;
 
+    ///
+    int getRemainingDuration() const;
+
+    /// Gets the ticks spent in a MineTruckState, up to the tick accounted for
+    int getTimeInState(TruckState) const;
+
     ///
     TruckState getTruckState() const;
 
     ///
-    void outputStationVisits(const std::string& timestamp);
+    void outputStationVisits(MineStatsSink& stats);
 
     ///
-    void outputStatistics(const std::string& timestamp) override;
+    void outputStatistics(MineStatsSink& stats) override;
 
     ///
     void setPlaceInQueue(int);
@@ -52,19 +72,27 @@ public:
     void setTruckState(TruckState);
 
     ///
-    void update(const std::string& timestamp) override;
+    void update(SimTime now) override;
 
 private:
-    static bool _initial;
-    static bool _revisited;
-
     std::string _truckName;
-    std::string _timestamp;
-    TruckStateMap _truckStates;
+    int _id;
+
+    // Every state is stored inline, and looked up by TruckState
+    MineTruckMining _mining{*this};
+    MineTruckInbound _inbound{*this};
+    MineTruckQueued _queued{*this};
+    MineTruckUnloading _unloading{*this};
+    MineTruckOutbound _outbound{*this};
+    const std::array<MineTruckState*, NUM_TRUCK_STATES> _truckStates{
+        &_mining, &_inbound, &_queued, &_unloading, &_outbound};
 
     MineTruckState* _currentState{nullptr};
     MineSite* _mineSite{nullptr};
     MineStation* _mineStation{nullptr};
     int _placeInQueue{0};
+    std::array<int, NUM_TRUCK_STATES> _timeInState{};  // Of the states left so far
+    SimTime _entered{-1};                              // Tick the current state was entered at
+    SimTime _now{-1};                                  // Tick accounted for up to
 };
 }  // namespace acme
\ No newline at end of file
@@ -1,14 +1,15 @@
 /// \file   MineTruckStates.cpp
 #include "MineTruckStates.h"
 
+#include "AcmeMinerUtils.h"
 #include "MineDefs.h"
 #include "MineDispatchers.h"
 #include "MineLogger.h"
 #include "MineSite.h"
 #include "MineStation.h"
+#include "MineStatsSink.h"
 #include "MineTruck.h"
 
-#include <sstream>
 
 namespace acme {
 ///
@@ -16,14 +17,25 @@ namespace acme {
 MineTruckMining::MineTruckMining(MineTruck& context)
     : _context(context) {}
 
+/// Counts down the ticks that elapsed without an update
+/// \param ticks
+void MineTruckMining::advance(int ticks) {
+    _duration -= ticks;
+}
+
 /// Sets up conditions when the state is entered
 /// \param duration
 void MineTruckMining::enterState() {
     auto* mineSite = _context.getAssignedMineSite();
-    mineSite->setMiningFlag(true);
+    mineSite->setMiningFlag(true, _context.getNow());
     _duration = mineSite->getMiningDuration();
 }
 
+/// Gets the ticks remaining before the state expires
+int MineTruckMining::getDuration() const {
+    return _duration;
+}
+
 ///
 TruckState MineTruckMining::getState() const {
     return TruckState::MINING;
@@ -31,29 +43,26 @@ TruckState MineTruckMining::getState() const {
 
 ///
 TruckState MineTruckMining::getNextState() const {
-    return TruckState::INBOUND;
+    return NEXT_TRUCK_STATE[index(getState())];
 }
 
 /// Gets the text of the state name
 const char* MineTruckMining::getStateName() const {
-    return TRUCK_STATE_NAME[TruckState::MINING];
-}
-
-///
-void MineTruckMining::outputStatistics(std::ofstream& truckOutput) {
-    truckOutput << (_timeInState * TICK_DURATION);
+    return TRUCK_STATE_NAME[index(TruckState::MINING)];
 }
 
 /// Updates the state with the context
-void MineTruckMining::update(const std::string& timestamp) {
+void MineTruckMining::update(SimTime now) {
     if (_duration % 5 == 0 || _duration < 10) {
-        std::ostringstream oss;
-        oss << timestamp << " : Truck   ";
-        oss << _context.getName() << " MINING    at " << _context.getAssignedMineSite()->getName();
-        oss << ", remaining duration " << (_duration * TICK_DURATION) << " minutes";
-        MineLogger::getInstance().logMessage(oss.str());
+        ACME_LOG(
+            INFO,
+            TRUCK,
+            _context.getId(),
+            tickToTimestamp(now) << " : Truck   " << _context.getName() << " MINING    at "
+                                 << _context.getAssignedMineSite()->getName()
+                                 << ", remaining duration " << (_duration * TICK_DURATION)
+                                 << " minutes");
     }
-    ++_timeInState;
     --_duration;
 
     if (_duration == 0) {
@@ -66,7 +75,16 @@ void MineTruckMining::update(const std::string& timestamp) {
 ///
 /// \param context
 MineTruckInbound::MineTruckInbound(MineTruck& context)
-    : _context(context) {}
+    : _context(context) {
+    // Recording a visit never allocates during the day
+    _stationsVisited.reserve(MAX_STATION_VISITS);
+}
+
+/// Counts down the ticks that elapsed without an update
+/// \param ticks
+void MineTruckInbound::advance(int ticks) {
+    _duration -= ticks;
+}
 
 /// Sets up conditions when the state is entered
 /// \param duration
@@ -77,14 +95,25 @@ void MineTruckInbound::enterState() {
     auto* mineStation =
         MineRegistry::getInstance().getStationDispatcher()->getNextAvailableStation();
     _context.assignMineStation(mineStation);
-    _stationsVisited[mineStation->getName()]++;
+    _stationsVisited.push_back(mineStation->getId());
 
     auto placeInQueue = mineStation->enqueue(&_context);
     _context.setPlaceInQueue(placeInQueue);
+    ACME_LOG(
+        DEBUG,
+        DISPATCHER,
+        _context.getId(),
+        "Dispatch " << _context.getName() << " to " << mineStation->getName() << ", place "
+                    << placeInQueue << " in queue");
     MineRegistry::getInstance().getStationDispatcher()->enqueue(mineStation);
 
     // No longer mining
-    _context.getAssignedMineSite()->setMiningFlag(false);
+    _context.getAssignedMineSite()->setMiningFlag(false, _context.getNow());
+}
+
+/// Gets the ticks remaining before the state expires
+int MineTruckInbound::getDuration() const {
+    return _duration;
 }
 
 ///
@@ -94,38 +123,35 @@ TruckState MineTruckInbound::getState() const {
 
 ///
 TruckState MineTruckInbound::getNextState() const {
-    return TruckState::QUEUED;
+    return NEXT_TRUCK_STATE[index(getState())];
 }
 
 /// Gets the text of the state name
 const char* MineTruckInbound::getStateName() const {
-    return TRUCK_STATE_NAME[TruckState::INBOUND];
+    return TRUCK_STATE_NAME[index(TruckState::INBOUND)];
 }
 
 ///
-void MineTruckInbound::outputStationVisits(std::ofstream& truckOutput) {
-    for (const auto& [station, count] : _stationsVisited) {
-        truckOutput << _context.getName() << "," << station << "," << count << std::endl;
+/// \param stats
+void MineTruckInbound::outputStationVisits(MineStatsSink& stats) {
+    for (auto station : _stationsVisited) {
+        stats.addStationVisits(_context.getId(), station, 1);
     }
 }
 
-///
-void MineTruckInbound::outputStatistics(std::ofstream& truckOutput) {
-    truckOutput << (_timeInState * TICK_DURATION);
-}
-
 /// Updates the state with the context
-void MineTruckInbound::update(const std::string& timestamp) {
+void MineTruckInbound::update(SimTime now) {
     if (_duration % 3 == 0) {
-        std::ostringstream oss;
-        oss << timestamp << " : Truck   ";
-        oss << _context.getName() << " INBOUND   to "
-            << _context.getAssignedMineStation()->getName();
-        oss << ", remaining duration " << (_duration * TICK_DURATION) << " minutes";
-        MineLogger::getInstance().logMessage(oss.str());
+        ACME_LOG(
+            INFO,
+            TRUCK,
+            _context.getId(),
+            tickToTimestamp(now) << " : Truck   " << _context.getName() << " INBOUND   to "
+                                 << _context.getAssignedMineStation()->getName()
+                                 << ", remaining duration " << (_duration * TICK_DURATION)
+                                 << " minutes");
     }
 
-    ++_timeInState;
     --_duration;
 
     if (_duration == 0) {
@@ -138,10 +164,24 @@ void MineTruckInbound::update(const std::string& timestamp) {
 MineTruckQueued::MineTruckQueued(MineTruck& context)
     : _context(context) {}
 
+/// Counts down the ticks that elapsed without an update
+/// \param ticks
+void MineTruckQueued::advance(int ticks) {
+    _duration -= ticks;
+}
+
 /// Sets up conditions when the state is entered
 /// \param duration
 void MineTruckQueued::enterState() {
     _duration = _context.getPlaceInQueue() * TRUCK_UNLOADING_TIME;
+
+    // Having reached the MineStation, this MineTruck may be the one it is waiting for
+    _context.getAssignedMineStation()->wake();
+}
+
+/// Gets the ticks remaining before the state expires
+int MineTruckQueued::getDuration() const {
+    return _duration;
 }
 
 ///
@@ -151,29 +191,25 @@ TruckState MineTruckQueued::getState() const {
 
 ///
 TruckState MineTruckQueued::getNextState() const {
-    return TruckState::UNLOADING;
+    return NEXT_TRUCK_STATE[index(getState())];
 }
 
 /// Gets the text of the state name
 const char* MineTruckQueued::getStateName() const {
-    return TRUCK_STATE_NAME[TruckState::QUEUED];
-}
-
-///
-void MineTruckQueued::outputStatistics(std::ofstream& truckOutput) {
-    truckOutput << (_timeInState * TICK_DURATION);
+    return TRUCK_STATE_NAME[index(TruckState::QUEUED)];
 }
 
 /// Updates the state with the context
-void MineTruckQueued::update(const std::string& timestamp) {
+void MineTruckQueued::update(SimTime now) {
     auto* mineStation = _context.getAssignedMineStation();
-    std::ostringstream oss;
-    oss << timestamp << " : Truck   ";
-    oss << _context.getName() << " QUEUED    at " << mineStation->getName();
-    oss << ", estimated wait time " << (_duration * TICK_DURATION) << " minutes";
-    MineLogger::getInstance().logMessage(oss.str());
+    ACME_LOG(
+        INFO,
+        TRUCK,
+        _context.getId(),
+        tickToTimestamp(now) << " : Truck   " << _context.getName() << " QUEUED    at "
+                             << mineStation->getName() << ", estimated wait time "
+                             << (_duration * TICK_DURATION) << " minutes");
 
-    ++_timeInState;
     --_duration;
 
     if (_duration == 0) {
@@ -192,12 +228,23 @@ void MineTruckQueued::update(const std::string& timestamp) {
 MineTruckUnloading::MineTruckUnloading(MineTruck& context)
     : _context(context) {}
 
+/// Counts down the ticks that elapsed without an update
+/// \param ticks
+void MineTruckUnloading::advance(int ticks) {
+    _duration -= ticks;
+}
+
 /// Sets up conditions when the state is entered
 /// \param duration
 void MineTruckUnloading::enterState() {
     _duration = TRUCK_UNLOADING_TIME;
 }
 
+/// Gets the ticks remaining before the state expires
+int MineTruckUnloading::getDuration() const {
+    return _duration;
+}
+
 ///
 TruckState MineTruckUnloading::getState() const {
     return TruckState::UNLOADING;
@@ -205,28 +252,24 @@ TruckState MineTruckUnloading::getState() const {
 
 ///
 TruckState MineTruckUnloading::getNextState() const {
-    return TruckState::OUTBOUND;
+    return NEXT_TRUCK_STATE[index(getState())];
 }
 
 /// Gets the text of the state name
 const char* MineTruckUnloading::getStateName() const {
-    return TRUCK_STATE_NAME[TruckState::UNLOADING];
-}
-
-///
-void MineTruckUnloading::outputStatistics(std::ofstream& truckOutput) {
-    truckOutput << (_timeInState * TICK_DURATION);
+    return TRUCK_STATE_NAME[index(TruckState::UNLOADING)];
 }
 
 /// Updates the state with the context
-void MineTruckUnloading::update(const std::string& timestamp) {
-    std::ostringstream oss;
-    oss << timestamp << " : Truck   ";
-    oss << _context.getName() << " UNLOADING at " << _context.getAssignedMineStation()->getName();
-    oss << ", duration 5 minutes";
-    MineLogger::getInstance().logMessage(oss.str());
-
-    ++_timeInState;
+void MineTruckUnloading::update(SimTime now) {
+    ACME_LOG(
+        INFO,
+        TRUCK,
+        _context.getId(),
+        tickToTimestamp(now) << " : Truck   " << _context.getName() << " UNLOADING at "
+                             << _context.getAssignedMineStation()->getName()
+                             << ", duration 5 minutes");
+
     --_duration;
 
     if (_duration == 0) {
@@ -239,14 +282,30 @@ void MineTruckUnloading::update(const std::string& timestamp) {
 MineTruckOutbound::MineTruckOutbound(MineTruck& context)
     : _context(context) {}
 
+/// Counts down the ticks that elapsed without an update
+/// \param ticks
+void MineTruckOutbound::advance(int ticks) {
+    _duration -= ticks;
+}
+
 /// Sets up conditions when the state is entered
 /// \param duration
 void MineTruckOutbound::enterState() {
     auto* mineSite = MineRegistry::getInstance().getSiteDispatcher()->getNextAvailableMine();
     _context.assignMineSite(mineSite);
+    ACME_LOG(
+        DEBUG,
+        DISPATCHER,
+        _context.getId(),
+        "Dispatch " << _context.getName() << " to " << mineSite->getName());
     _duration = TRUCK_TRANSIT_TIME;
 }
 
+/// Gets the ticks remaining before the state expires
+int MineTruckOutbound::getDuration() const {
+    return _duration;
+}
+
 ///
 TruckState MineTruckOutbound::getState() const {
     return TruckState::OUTBOUND;
@@ -254,30 +313,27 @@ TruckState MineTruckOutbound::getState() const {
 
 ///
 TruckState MineTruckOutbound::getNextState() const {
-    return TruckState::MINING;
+    return NEXT_TRUCK_STATE[index(getState())];
 }
 
 /// Gets the text of the state name
 const char* MineTruckOutbound::getStateName() const {
-    return TRUCK_STATE_NAME[TruckState::OUTBOUND];
-}
-
-///
-void MineTruckOutbound::outputStatistics(std::ofstream& truckOutput) {
-    truckOutput << (_timeInState * TICK_DURATION);
+    return TRUCK_STATE_NAME[index(TruckState::OUTBOUND)];
 }
 
 /// Updates the state with the context
-void MineTruckOutbound::update(const std::string& timestamp) {
+void MineTruckOutbound::update(SimTime now) {
     if (_duration % 5 == 0 || _duration < 10) {
-        std::ostringstream oss;
-        oss << timestamp << " : Truck   ";
-        oss << _context.getName() << " OUTBOUND  to " << _context.getAssignedMineSite()->getName();
-        oss << ", remaining duration " << (_duration * TICK_DURATION) << " minutes";
-        MineLogger::getInstance().logMessage(oss.str());
+        ACME_LOG(
+            INFO,
+            TRUCK,
+            _context.getId(),
+            tickToTimestamp(now) << " : Truck   " << _context.getName() << " OUTBOUND  to "
+                                 << _context.getAssignedMineSite()->getName()
+                                 << ", remaining duration " << (_duration * TICK_DURATION)
+                                 << " minutes");
     }
 
-    ++_timeInState;
     --_duration;
 
     if (_duration == 0) {
@@ -1,39 +1,58 @@
 /// \file   MineTruckStates.h
 #pragma once
-#include <iosfwd>
-#include <memory>
-#include <string>
-#include <unordered_map>
+#include "MineDefs.h"
+#include "MineTimer.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace acme {
+class MineStatsSink;
 class MineTruck;
 
 /// MineTruck states
-enum class TruckState { MINING, INBOUND, QUEUED, UNLOADING, OUTBOUND };
+enum class TruckState : std::uint8_t { MINING, INBOUND, QUEUED, UNLOADING, OUTBOUND };
+
+constexpr std::size_t NUM_TRUCK_STATES = 5;
+
+/// Position of a TruckState in per-state tables
+constexpr std::size_t index(TruckState truckState) {
+    return static_cast<std::size_t>(truckState);
+}
 
 /// Enum to string mapping
-static std::unordered_map<TruckState, const char*> TRUCK_STATE_NAME{
-    {TruckState::MINING, "MINING"},
-    {TruckState::INBOUND, "INBOUND"},
-    {TruckState::QUEUED, "QUEUED"},
-    {TruckState::UNLOADING, "UNLOADING"},
-    {TruckState::OUTBOUND, "OUTBOUND"}};
+constexpr std::array<const char*, NUM_TRUCK_STATES> TRUCK_STATE_NAME{
+    "MINING", "INBOUND", "QUEUED", "UNLOADING", "OUTBOUND"};
+
+/// The TruckState that follows each one when it expires
+constexpr std::array<TruckState, NUM_TRUCK_STATES> NEXT_TRUCK_STATE{
+    TruckState::INBOUND,
+    TruckState::QUEUED,
+    TruckState::UNLOADING,
+    TruckState::OUTBOUND,
+    TruckState::MINING};
+
+/// Most MineStation visits a MineTruck can make in a day: each round trip mines for at least
+/// H3_MINING_MIN, travels both ways, and spends at least an unloading time queued and unloading
+constexpr int MAX_STATION_VISITS =
+    TICKS_PER_DAY / (H3_MINING_MIN + 2 * TRUCK_TRANSIT_TIME + 2 * TRUCK_UNLOADING_TIME) + 1;
 
 /// \class  MineTruckState
 /// \brief  ABC for MineTruck states
 class MineTruckState {
 public:
     virtual ~MineTruckState() = default;
+    virtual void advance(int ticks) = 0;
     virtual void enterState() = 0;
+    virtual int getDuration() const = 0;
     virtual TruckState getState() const = 0;
     virtual TruckState getNextState() const = 0;
     virtual const char* getStateName() const = 0;
-    virtual void outputStatistics(std::ofstream&) = 0;
-    virtual void update(const std::string&) = 0;
+    virtual void update(SimTime now) = 0;
 };
 
-using TruckStateMap = std::unordered_map<TruckState, std::shared_ptr<MineTruckState>>;
-
 /// \class  MineTruckMining
 /// \brief  Concrete MINING state
 class MineTruckMining : public MineTruckState {
@@ -45,10 +64,16 @@ public:
     ///
     ~MineTruckMining() override = default;
 
+    /// Counts down the ticks that elapsed without an update
+    void advance(int ticks) override;
+
     /// Sets up conditions when the state is entered
     /// \param duration
     void enterState() override;
 
+    /// Gets the ticks remaining before the state expires
+    int getDuration() const override;
+
     ///
     TruckState getState() const override;
 
@@ -59,15 +84,11 @@ public:
     const char* getStateName() const override;
 
     ///
-    void outputStatistics(std::ofstream&) override;
-
-    ///
-    void update(const std::string&) override;
+    void update(SimTime now) override;
 
 private:
     MineTruck& _context;
     int _duration{0};
-    int _timeInState{0};
 };
 
 /// \class  MineTruckInbound
@@ -81,10 +102,16 @@ public:
     ///
     ~MineTruckInbound() override = default;
 
+    /// Counts down the ticks that elapsed without an update
+    void advance(int ticks) override;
+
     /// Sets up conditions when the state is entered
     /// \param duration
     void enterState() override;
 
+    /// Gets the ticks remaining before the state expires
+    int getDuration() const override;
+
     ///
     TruckState getState() const override;
 
@@ -95,19 +122,15 @@ public:
     const char* getStateName() const override;
 
     ///
-    void outputStationVisits(std::ofstream&);
-
-    ///
-    void outputStatistics(std::ofstream&) override;
+    void outputStationVisits(MineStatsSink&);
 
     ///
-    void update(const std::string&) override;
+    void update(SimTime now) override;
 
 private:
     MineTruck& _context;
     int _duration{0};
-    int _timeInState{0};
-    std::unordered_map<std::string, int> _stationsVisited;
+    std::vector<std::int32_t> _stationsVisited;  // MineStation id of every visit
 };
 
 /// \class  MineTruckQueued
@@ -121,10 +144,16 @@ public:
     ///
     ~MineTruckQueued() override = default;
 
+    /// Counts down the ticks that elapsed without an update
+    void advance(int ticks) override;
+
     /// Sets up conditions when the state is entered
     /// \param duration
     void enterState() override;
 
+    /// Gets the ticks remaining before the state expires
+    int getDuration() const override;
+
     ///
     TruckState getState() const override;
 
@@ -135,15 +164,11 @@ public:
     const char* getStateName() const override;
 
     ///
-    void outputStatistics(std::ofstream&) override;
-
-    ///
-    void update(const std::string&) override;
+    void update(SimTime now) override;
 
 private:
     MineTruck& _context;
     int _duration{0};
-    int _timeInState{0};
 };
 
 /// \class  MineTruckUnloading
@@ -157,10 +182,16 @@ public:
     ///
     ~MineTruckUnloading() override = default;
 
+    /// Counts down the ticks that elapsed without an update
+    void advance(int ticks) override;
+
     /// Sets up conditions when the state is entered
     /// \param duration
     void enterState() override;
 
+    /// Gets the ticks remaining before the state expires
+    int getDuration() const override;
+
     ///
     TruckState getState() const override;
 
@@ -171,15 +202,11 @@ public:
     const char* getStateName() const override;
 
     ///
-    void outputStatistics(std::ofstream&) override;
-
-    ///
-    void update(const std::string&) override;
+    void update(SimTime now) override;
 
 private:
     MineTruck& _context;
     int _duration{0};
-    int _timeInState{0};
 };
 
 /// \class  MineTruckOutbound
@@ -193,10 +220,16 @@ public:
     ///
     ~MineTruckOutbound() override = default;
 
+    /// Counts down the ticks that elapsed without an update
+    void advance(int ticks) override;
+
     /// Sets up conditions when the state is entered
     /// \param duration
     void enterState() override;
 
+    /// Gets the ticks remaining before the state expires
+    int getDuration() const override;
+
     ///
     TruckState getState() const override;
 
@@ -207,14 +240,10 @@ public:
     const char* getStateName() const override;
 
     ///
-    void outputStatistics(std::ofstream&) override;
-
-    ///
-    void update(const std::string&) override;
+    void update(SimTime now) override;
 
 private:
     MineTruck& _context;
     int _duration{0};
-    int _timeInState{0};
 };
 }  // namespace acme
\ No newline at end of file
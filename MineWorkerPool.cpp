@@ -0,0 +1,87 @@
+/// \file   MineWorkerPool.cpp
+#include "MineWorkerPool.h"
+
+#include "MineTrace.h"
+
+#include <algorithm>
+#include <string>
+
+namespace acme {
+///
+/// \param numWorkers
+MineWorkerPool::MineWorkerPool(int numWorkers) {
+    if (numWorkers <= 0) {
+        numWorkers = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+    }
+
+    for (auto worker = 1; worker < numWorkers; ++worker) {
+        _threads.emplace_back(&MineWorkerPool::workerLoop, this, worker);
+    }
+}
+
+///
+MineWorkerPool::~MineWorkerPool() {
+    {
+        std::lock_guard<std::mutex> lockGuard(_mutex);
+        _stopping = true;
+    }
+    _wakeup.notify_all();
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+/// Runs task(worker) on every worker, and returns once all of them have finished
+/// \param task
+void MineWorkerPool::run(const std::function<void(int)>& task) {
+    if (!_threads.empty()) {
+        std::lock_guard<std::mutex> lockGuard(_mutex);
+        _task = &task;
+        _pending = static_cast<int>(_threads.size());
+        ++_generation;
+    }
+    _wakeup.notify_all();
+
+    task(0);
+
+    if (!_threads.empty()) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finished.wait(lock, [this] { return _pending == 0; });
+        _task = nullptr;
+    }
+}
+
+///
+int MineWorkerPool::size() const {
+    return static_cast<int>(_threads.size()) + 1;
+}
+
+/// Waits for each new task, runs it, and reports back
+/// \param worker
+void MineWorkerPool::workerLoop(int worker) {
+    MineTrace::getInstance().setThreadName("worker " + std::to_string(worker));
+    std::uint64_t generation = 0;
+    while (true) {
+        const std::function<void(int)>* task = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeup.wait(lock, [this, generation] {
+                return _stopping || _generation != generation;
+            });
+            if (_stopping) {
+                return;
+            }
+            generation = _generation;
+            task = _task;
+        }
+
+        (*task)(worker);
+
+        std::lock_guard<std::mutex> lockGuard(_mutex);
+        if (--_pending == 0) {
+            _finished.notify_one();
+        }
+    }
+}
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,46 @@
+/// \file   MineWorkerPool.h
+/// \brief  Fixed pool of worker threads that run one task in lockstep
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace acme {
+/// \class  MineWorkerPool
+/// \brief  Runs the same task on every worker and waits for all of them, once per call
+/// \note   The calling thread takes part as worker 0, so a pool of one spawns no threads at all
+class MineWorkerPool {
+public:
+    /// Constructor; 0 workers means one per hardware thread
+    /// \param numWorkers
+    explicit MineWorkerPool(int numWorkers);
+
+    MineWorkerPool() = delete;
+    MineWorkerPool(const MineWorkerPool&) = delete;
+    MineWorkerPool& operator=(const MineWorkerPool&) = delete;
+
+    ///
+    ~MineWorkerPool();
+
+    ///
+    void run(const std::function<void(int)>& task);
+
+    ///
+    int size() const;
+
+private:
+    void workerLoop(int worker);
+
+    std::vector<std::thread> _threads;
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::condition_variable _finished;
+    const std::function<void(int)>* _task{nullptr};
+    std::uint64_t _generation{0};
+    int _pending{0};
+    bool _stopping{false};
+};
+}  // namespace acme
\ No newline at end of file
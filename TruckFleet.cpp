@@ -0,0 +1,755 @@
+/// \file   TruckFleet.cpp
+#include "TruckFleet.h"
+
+#include "MineCheckpoint.h"
+#include "MineJournal.h"
+#include "MinePacer.h"
+#include "MineStatsSink.h"
+#include "MineTrace.h"
+#include "MineWorkerPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace acme {
+namespace {
+/// Partition boundaries fall on 64-byte lines of 32-bit entries, so workers never share one
+constexpr std::int32_t PARTITION_ALIGNMENT = 16;
+
+/// Checks that every entry of an array read from a checkpoint indexes an array of count entries
+/// \param values
+/// \param count
+/// \param fileName
+/// \throws std::runtime_error if one does not
+template <typename Values>
+void checkIndices(const Values& values, std::size_t count, const std::string& fileName) {
+    for (const auto& value : values) {
+        if (static_cast<std::size_t>(value) >= count) {
+            throw std::runtime_error(fileName + " holds an entry out of range");
+        }
+    }
+}
+
+/// Divides, or returns 0 for nothing out of nothing
+double ratio(double numerator, double denominator) {
+    return denominator != 0 ? numerator / denominator : 0.0;
+}
+}  // namespace
+
+///
+double FleetSummary::getDeliveriesPerHour() const {
+    return ratio(static_cast<double>(deliveries), MINING_DAY);
+}
+
+///
+double FleetSummary::getMeanQueueWait() const {
+    return ratio(static_cast<double>(queuedTicks) * TICK_DURATION, static_cast<double>(deliveries));
+}
+
+///
+double FleetSummary::getSiteUtilization() const {
+    return ratio(static_cast<double>(miningTicks), static_cast<double>(siteTicks));
+}
+
+///
+double FleetSummary::getStationUtilization() const {
+    return ratio(static_cast<double>(unloadingTicks), static_cast<double>(stationTicks));
+}
+
+/// Allocates every array once; all stations start IDLE, and all sites idle in the dispatcher queue
+/// \param numTrucks
+/// \param numStations
+/// \param numSites
+/// \param seed
+/// \param durations
+TruckFleet::TruckFleet(
+    int numTrucks,
+    int numStations,
+    int numSites,
+    std::uint64_t seed,
+    const FleetDurations& durations)
+    : _seed(seed)
+    , _durations(durations)
+    , _truckState(numTrucks, TruckState::MINING)
+    , _truckRemaining(numTrucks, 0)
+    , _truckSite(numTrucks, 0)
+    , _truckStation(numTrucks, 0)
+    , _truckPlaceInQueue(numTrucks, 0)
+    , _truckEntered(numTrucks, -1)
+    , _truckService(numTrucks, TruckService::ACTIVE)
+    , _stationState(numStations, StationState::IDLE)
+    , _stationRemaining(numStations, 0)
+    , _stationEntered(numStations, -1)
+    , _stationQueues(numStations)
+    , _siteMining(numSites, 0)
+    , _siteChanged(numSites, 0)
+    , _siteIdleTime(numSites, 0)
+    , _siteMiningTime(numSites, 0) {
+    for (auto& truckTime : _truckTime) {
+        truckTime.assign(numTrucks, 0);
+    }
+    for (auto& stationTime : _stationTime) {
+        stationTime.assign(numStations, 0);
+    }
+    // As MAX_STATION_VISITS, for these durations
+    auto shortestTrip = _durations.miningMin + 2 * _durations.transitTime
+                        + 2 * _durations.unloadingTime;
+    auto maxStationVisits = TICKS_PER_DAY / std::max(shortestTrip, 1) + 1;
+    _stationVisits.reserve(static_cast<std::size_t>(numTrucks) * maxStationVisits);
+
+    // Like the MineSite constructor, each timer draws its first mining time up front
+    _siteTimers.reserve(numSites);
+    for (std::int32_t site = 0; site < numSites; ++site) {
+        _siteTimers.emplace_back(_durations.miningMin, _durations.miningMax, seed, site);
+        _siteTimers.back()();
+        _siteQueue.push(site);
+    }
+
+    for (std::int32_t station = 0; station < numStations; ++station) {
+        _stationHeap.push(station, 0);
+    }
+
+    partition(1);
+    auto& dispatchOps = _counts[0].counts.dispatchOps;
+    dispatchOps[static_cast<std::size_t>(DispatchOp::SITE_ENQUEUE)] += numSites;
+    dispatchOps[static_cast<std::size_t>(DispatchOp::STATION_ENQUEUE)] += numStations;
+}
+
+/// Appends the stations, each accounted for from the next tick on, as a day's stations are from
+/// tick 0
+/// \param count
+void TruckFleet::addStations(int count) {
+    for (auto added = 0; added < count; ++added) {
+        auto station = static_cast<std::int32_t>(_stationState.size());
+        _stationState.push_back(StationState::IDLE);
+        _stationRemaining.push_back(0);
+        _stationEntered.push_back(_nextTick - 1);
+        for (auto& stationTime : _stationTime) {
+            stationTime.push_back(0);
+        }
+        _stationQueues.emplace_back();
+        _stationHeap.push(station, 0);
+        ++_counts[0].counts.dispatchOps[static_cast<std::size_t>(DispatchOp::STATION_ENQUEUE)];
+    }
+    partition(static_cast<int>(_numExpired.size()));
+}
+
+/// Counts one partition of the trucks down in a branch-free pass over contiguous memory,
+/// gathering the ones whose state expires on this tick
+/// \param partition
+void TruckFleet::countDown(int partition) {
+    auto span = MineTraceSpan("countDown");
+    auto* remaining = _truckRemaining.data();
+    auto* expired = _expired[partition].data();
+    const auto first = _truckPartitions[partition];
+    const auto last = _truckPartitions[partition + 1];
+
+    std::int32_t numExpired = 0;
+    for (auto truck = first; truck < last; ++truck) {
+        auto left = --remaining[truck];
+        expired[numExpired] = truck;
+        numExpired += (left == 0);
+    }
+    _numExpired[partition] = numExpired;
+}
+
+/// Accumulates the ticks spent in the current StationState, then enters a new one
+/// \param station
+/// \param stationState
+/// \param now
+/// \param partition      whose counters count the transition
+void TruckFleet::enterStationState(
+    std::int32_t station,
+    StationState stationState,
+    SimTime now,
+    int partition) {
+    _stationTime[index(_stationState[station])][station] += now - _stationEntered[station];
+    _stationEntered[station] = now;
+    _stationState[station] = stationState;
+    ++_counts[partition].counts.stationTransitions[index(stationState)];
+
+    if (stationState == StationState::UNLOADING) {
+        _stationRemaining[station] = _durations.unloadingTime;
+    }
+}
+
+/// Accumulates the ticks spent in the current TruckState, then enters a new one
+/// \param truck
+/// \param truckState
+/// \param now
+void TruckFleet::enterTruckState(std::int32_t truck, TruckState truckState, SimTime now) {
+    _truckTime[index(_truckState[truck])][truck] += now - _truckEntered[truck];
+    _truckEntered[truck] = now;
+    _truckState[truck] = truckState;
+    auto& counts = _counts[0].counts;
+    ++counts.truckTransitions[index(truckState)];
+    if (_journal) {
+        _journal->enterState(now, truck, truckState);
+    }
+
+    switch (truckState) {
+    case TruckState::MINING: {
+        auto site = _truckSite[truck];
+        setMiningFlag(site, true, now);
+        _truckRemaining[truck] = _siteTimers[site]();
+        break;
+    }
+    case TruckState::INBOUND: {
+        // Join the shortest MineStation queue
+        _truckRemaining[truck] = _durations.transitTime;
+        auto station = _stationHeap.top();
+        ++counts.dispatchOps[static_cast<std::size_t>(DispatchOp::STATION_SELECT)];
+        _truckStation[truck] = station;
+        _stationVisits.emplace_back(truck, station);
+
+        _stationQueues[station].push(truck);
+        _truckPlaceInQueue[truck] = static_cast<std::int32_t>(_stationQueues[station].size());
+        _stationHeap.update(station, _truckPlaceInQueue[truck]);
+        ++counts.dispatchOps[static_cast<std::size_t>(DispatchOp::STATION_ENQUEUE)];
+
+        setMiningFlag(_truckSite[truck], false, now);
+        if (_journal) {
+            _journal->dispatchToStation(now, truck, station, _truckPlaceInQueue[truck]);
+        }
+        break;
+    }
+    case TruckState::QUEUED:
+        _truckRemaining[truck] = _truckPlaceInQueue[truck] * _durations.unloadingTime;
+        break;
+    case TruckState::UNLOADING:
+        _truckRemaining[truck] = _durations.unloadingTime;
+        break;
+    case TruckState::OUTBOUND:
+        _truckSite[truck] = _siteQueue.pop();
+        ++counts.dispatchOps[static_cast<std::size_t>(DispatchOp::SITE_DEQUEUE)];
+        _truckRemaining[truck] = _durations.transitTime;
+        if (_journal) {
+            _journal->dispatchToSite(now, truck, _truckSite[truck]);
+        }
+        break;
+    }
+}
+
+/// Carries out the end of a truck's current state
+/// \param truck
+/// \param now
+void TruckFleet::expireTruck(std::int32_t truck, SimTime now) {
+    auto& dispatchOps = _counts[0].counts.dispatchOps;
+    switch (_truckState[truck]) {
+    case TruckState::MINING:
+        _siteQueue.push(_truckSite[truck]);
+        ++dispatchOps[static_cast<std::size_t>(DispatchOp::SITE_ENQUEUE)];
+        enterTruckState(truck, TruckState::INBOUND, now);
+        break;
+    case TruckState::INBOUND:
+        enterTruckState(truck, TruckState::QUEUED, now);
+        break;
+    case TruckState::QUEUED: {
+        // As in MineTruckQueued, the front of the queue leaves, which is not necessarily this truck
+        auto station = _truckStation[truck];
+        _stationQueues[station].pop();
+        _stationHeap.update(station, static_cast<std::int32_t>(_stationQueues[station].size()));
+        ++dispatchOps[static_cast<std::size_t>(DispatchOp::STATION_ENQUEUE)];
+        enterTruckState(truck, TruckState::UNLOADING, now);
+        break;
+    }
+    case TruckState::UNLOADING:
+        // A withdrawn truck leaves service instead of heading back to a site
+        if (_truckService[truck] == TruckService::LEAVING) {
+            park(truck, now);
+        } else {
+            enterTruckState(truck, TruckState::OUTBOUND, now);
+        }
+        break;
+    case TruckState::OUTBOUND:
+        enterTruckState(truck, TruckState::MINING, now);
+        break;
+    }
+}
+
+/// Closes the open time-in-state intervals at the end of the day; parked trucks closed theirs
+/// when they left
+/// \param lastTick
+void TruckFleet::finish(SimTime lastTick) {
+    for (std::size_t truck = 0; truck < _truckState.size(); ++truck) {
+        if (_truckService[truck] == TruckService::PARKED) {
+            continue;
+        }
+        _truckTime[index(_truckState[truck])][truck] += lastTick - _truckEntered[truck];
+        _truckEntered[truck] = lastTick;
+    }
+
+    for (std::size_t station = 0; station < _stationState.size(); ++station) {
+        _stationTime[index(_stationState[station])][station] += lastTick - _stationEntered[station];
+        _stationEntered[station] = lastTick;
+    }
+
+    // Sites count the tick on which their flag changes, so their intervals run one tick further
+    for (std::size_t site = 0; site < _siteMining.size(); ++site) {
+        auto& siteTime = _siteMining[site] ? _siteMiningTime : _siteIdleTime;
+        siteTime[site] += lastTick + 1 - _siteChanged[site];
+        _siteChanged[site] = lastTick + 1;
+    }
+}
+
+///
+/// \param site
+int TruckFleet::getIdleTime(int site) const {
+    return _siteIdleTime[site];
+}
+
+///
+/// \param site
+int TruckFleet::getMiningTime(int site) const {
+    return _siteMiningTime[site];
+}
+
+///
+SimTime TruckFleet::getNextTick() const {
+    return _nextTick;
+}
+
+///
+std::uint64_t TruckFleet::getSeed() const {
+    return _seed;
+}
+
+/// A visit is completed once its truck has left the station
+FleetSummary TruckFleet::getSummary() const {
+    FleetSummary summary{};
+    std::int64_t unfinishedVisits = 0;
+    for (std::size_t truck = 0; truck < _truckState.size(); ++truck) {
+        if (_truckService[truck] != TruckService::PARKED) {
+            ++summary.numTrucks;
+            auto truckState = _truckState[truck];
+            unfinishedVisits += truckState == TruckState::INBOUND
+                                || truckState == TruckState::QUEUED
+                                || truckState == TruckState::UNLOADING;
+        }
+        summary.queuedTicks += _truckTime[index(TruckState::QUEUED)][truck];
+    }
+    summary.deliveries = static_cast<std::int64_t>(_stationVisits.size()) - unfinishedVisits;
+
+    summary.numStations = static_cast<std::int32_t>(_stationState.size());
+    for (std::size_t station = 0; station < _stationState.size(); ++station) {
+        summary.unloadingTicks += _stationTime[index(StationState::UNLOADING)][station];
+        for (const auto& stationTime : _stationTime) {
+            summary.stationTicks += stationTime[station];
+        }
+    }
+
+    for (std::size_t site = 0; site < _siteMining.size(); ++site) {
+        summary.miningTicks += _siteMiningTime[site];
+        summary.siteTicks += _siteIdleTime[site] + _siteMiningTime[site];
+    }
+    return summary;
+}
+
+///
+/// \param truck
+/// \param truckState
+int TruckFleet::getTimeInState(int truck, TruckState truckState) const {
+    return _truckTime[index(truckState)][truck];
+}
+
+///
+/// \param station
+/// \param stationState
+int TruckFleet::getTimeInState(int station, StationState stationState) const {
+    return _stationTime[index(stationState)][station];
+}
+
+/// Records the stations that changed state on this tick; a station changes at most once per tick,
+/// and the workers cannot share the MineJournal, so this is done after they have finished
+/// \param now
+void TruckFleet::journalStations(SimTime now) {
+    for (std::int32_t station = 0; station < static_cast<std::int32_t>(_stationState.size());
+         ++station) {
+        if (_stationEntered[station] == now) {
+            _journal->enterState(now, station, _stationState[station]);
+        }
+    }
+}
+
+/// Adds the counters of every partition to MineMetrics, then clears them
+void TruckFleet::mergeMetrics() {
+    auto& metrics = MineMetrics::getInstance();
+    for (auto& partition : _counts) {
+        metrics.merge(partition.counts);
+        partition.counts = {};
+    }
+}
+
+/// Outputs the same statistics as the MineMinions
+/// \param stats
+void TruckFleet::outputStatistics(MineStatsSink& stats) const {
+    for (std::size_t truck = 0; truck < _truckState.size(); ++truck) {
+        TruckTimes ticks{};
+        for (std::size_t state = 0; state < ticks.size(); ++state) {
+            ticks[state] = _truckTime[state][truck];
+        }
+        stats.addTruck(static_cast<int>(truck), ticks);
+    }
+
+    for (std::size_t station = 0; station < _stationState.size(); ++station) {
+        StationTimes ticks{};
+        for (std::size_t state = 0; state < ticks.size(); ++state) {
+            ticks[state] = _stationTime[state][station];
+        }
+        stats.addStation(static_cast<int>(station), ticks);
+    }
+
+    for (std::size_t site = 0; site < _siteMining.size(); ++site) {
+        stats.addSite(static_cast<int>(site), _siteIdleTime[site], _siteMiningTime[site]);
+    }
+
+    // Station visits are logged in visit order; the sink counts them
+    for (const auto& [truck, station] : _stationVisits) {
+        stats.addStationVisits(truck, station, 1);
+    }
+}
+
+/// Takes a truck out of service, closing its current time-in-state interval; it never expires again
+/// \param truck
+/// \param now
+void TruckFleet::park(std::int32_t truck, SimTime now) {
+    _truckTime[index(_truckState[truck])][truck] += now - _truckEntered[truck];
+    _truckEntered[truck] = now;
+    _truckRemaining[truck] = PARKED_REMAINING;
+    _truckService[truck] = TruckService::PARKED;
+}
+
+/// Splits the trucks and stations into contiguous ranges, one per worker
+/// \param numPartitions
+void TruckFleet::partition(int numPartitions) {
+    auto split = [numPartitions](std::int32_t count, std::vector<std::int32_t>& boundaries) {
+        boundaries.assign(numPartitions + 1, count);
+        for (auto part = 0; part < numPartitions; ++part) {
+            auto boundary = static_cast<std::int64_t>(count) * part / numPartitions;
+            boundaries[part] = std::min(
+                count,
+                static_cast<std::int32_t>(boundary - boundary % PARTITION_ALIGNMENT));
+        }
+    };
+    split(static_cast<std::int32_t>(_truckState.size()), _truckPartitions);
+    split(static_cast<std::int32_t>(_stationState.size()), _stationPartitions);
+
+    _expired.resize(numPartitions);
+    for (auto part = 0; part < numPartitions; ++part) {
+        _expired[part].assign(_truckPartitions[part + 1] - _truckPartitions[part] + 1, 0);
+    }
+    _numExpired.assign(numPartitions, 0);
+    _counts.resize(numPartitions);
+}
+
+/// Restores every array, queue and timer in the order writeCheckpoint wrote them; the station
+/// heap is rebuilt from the queue sizes, as its order depends on nothing else
+/// \param fileName
+/// \throws std::runtime_error if the file is not a checkpoint of a fleet of this size, or holds a
+///         state, id, queue entry, tick or duration out of range
+void TruckFleet::readCheckpoint(const std::string& fileName) {
+    auto reader = MineCheckpointReader(fileName);
+    const auto& header = reader.getHeader();
+    if (header.numTrucks != _truckState.size() || header.numStations != _stationState.size()
+        || header.numSites != _siteMining.size()) {
+        throw std::runtime_error(
+            fileName + " was taken with " + std::to_string(header.numTrucks) + " trucks, "
+            + std::to_string(header.numStations) + " stations and "
+            + std::to_string(header.numSites) + " sites");
+    }
+    _seed = header.seed;
+    _nextTick = header.nextTick;
+
+    // Every state, id and queue entry is checked before it can index anything; every time a state
+    // was entered, or a site's flag changed, lies between the tick before the day and the next tick
+    const auto numTrucks = _truckState.size();
+    const auto numStations = _stationState.size();
+    const auto numSites = _siteMining.size();
+    auto readArray = [&reader](auto& values) { reader.read(values.data(), values.size()); };
+    auto checkTicks = [&](const std::vector<SimTime>& ticks) {
+        for (auto tick : ticks) {
+            if (tick < -1 || tick > _nextTick) {
+                throw std::runtime_error(fileName + " holds a tick after its next tick");
+            }
+        }
+    };
+    readArray(_truckState);
+    checkIndices(_truckState, NUM_TRUCK_STATES, fileName);
+    readArray(_truckRemaining);
+    readArray(_truckSite);
+    checkIndices(_truckSite, numSites, fileName);
+    readArray(_truckStation);
+    checkIndices(_truckStation, numStations, fileName);
+    readArray(_truckPlaceInQueue);
+    readArray(_truckEntered);
+    checkTicks(_truckEntered);
+    readArray(_truckService);
+    checkIndices(_truckService, static_cast<std::size_t>(TruckService::PARKED) + 1, fileName);
+    reader.read(&_durations, 1);
+    if (_durations.transitTime < 1 || _durations.unloadingTime < 1 || _durations.miningMin < 1
+        || _durations.miningMin > _durations.miningMax) {
+        throw std::runtime_error(fileName + " holds invalid durations");
+    }
+    for (auto& truckTime : _truckTime) {
+        readArray(truckTime);
+    }
+    reader.read(_stationVisits);
+    for (const auto& [truck, station] : _stationVisits) {
+        if (static_cast<std::size_t>(truck) >= numTrucks
+            || static_cast<std::size_t>(station) >= numStations) {
+            throw std::runtime_error(fileName + " holds an entry out of range");
+        }
+    }
+
+    readArray(_stationState);
+    checkIndices(_stationState, NUM_STATION_STATES, fileName);
+    readArray(_stationRemaining);
+    readArray(_stationEntered);
+    checkTicks(_stationEntered);
+    for (auto& stationTime : _stationTime) {
+        readArray(stationTime);
+    }
+    std::vector<std::int32_t> queueSizes(_stationQueues.size());
+    std::vector<std::int32_t> queued;
+    readArray(queueSizes);
+    reader.read(queued);
+    checkIndices(queued, numTrucks, fileName);
+    auto next = queued.begin();
+    for (std::size_t station = 0; station < _stationQueues.size(); ++station) {
+        if (queueSizes[station] < 0 || queueSizes[station] > queued.end() - next) {
+            throw std::runtime_error(fileName + " has inconsistent station queues");
+        }
+        auto& stationQueue = _stationQueues[station];
+        stationQueue = {};
+        for (auto place = 0; place < queueSizes[station]; ++place) {
+            stationQueue.push(*next++);
+        }
+        _stationHeap.update(static_cast<std::int32_t>(station), queueSizes[station]);
+    }
+    if (next != queued.end()) {
+        throw std::runtime_error(fileName + " has inconsistent station queues");
+    }
+
+    readArray(_siteMining);
+    readArray(_siteChanged);
+    checkTicks(_siteChanged);
+    readArray(_siteIdleTime);
+    readArray(_siteMiningTime);
+    readArray(_siteTimers);
+    reader.read(queued);
+    checkIndices(queued, numSites, fileName);
+    _siteQueue = {};
+    for (auto site : queued) {
+        _siteQueue.push(site);
+    }
+}
+
+/// Runs through a simulation 'day' (72 hours), or the part of it up to endTick; ticks are paced
+/// from the first one run here
+/// \param pacer
+/// \param endTick
+void TruckFleet::run(MinePacer& pacer, SimTime endTick) {
+    for (auto tick = _nextTick; tick < endTick; ++tick) {
+        pacer.awaitTick(tick);
+        auto tickTimer = MinePhaseTimer(MetricPhase::TICK_UPDATE);
+        this->tick(tick);
+    }
+    if (endTick == TICKS_PER_DAY) {
+        finish(TICKS_PER_DAY - 1);
+    }
+    mergeMetrics();
+}
+
+///
+/// \param journal
+void TruckFleet::setJournal(MineJournal* journal) {
+    _journal = journal;
+}
+
+/// Sets a site's mining flag, accumulating the ticks spent with the old value
+/// \param site
+/// \param beingMined
+/// \param now
+void TruckFleet::setMiningFlag(std::int32_t site, bool beingMined, SimTime now) {
+    auto& siteTime = _siteMining[site] ? _siteMiningTime : _siteIdleTime;
+    siteTime[site] += now - _siteChanged[site];
+    _siteChanged[site] = now;
+    _siteMining[site] = beingMined;
+}
+
+///
+/// \param ticks
+void TruckFleet::setTransitTime(int ticks) {
+    _durations.transitTime = ticks;
+}
+
+/// Splits each tick across a MineWorkerPool; nullptr runs on the calling thread only
+/// \param workerPool
+void TruckFleet::setWorkerPool(MineWorkerPool* workerPool) {
+    _workerPool = workerPool;
+    partition(workerPool ? workerPool->size() : 1);
+}
+
+/// Makes the initial association of trucks with mines; all trucks start MINING
+void TruckFleet::startTrucksAtMines() {
+    for (std::int32_t truck = 0; truck < static_cast<std::int32_t>(_truckState.size()); ++truck) {
+        auto site = _siteQueue.pop();
+        _truckSite[truck] = site;
+        _siteMining[site] = 1;
+        ++_counts[0].counts.dispatchOps[static_cast<std::size_t>(DispatchOp::SITE_DEQUEUE)];
+        ++_counts[0].counts.truckTransitions[index(TruckState::MINING)];
+        _truckRemaining[truck] = _siteTimers[site]();
+        if (_journal) {
+            _journal->dispatchToSite(-1, truck, site);
+            _journal->enterState(-1, truck, TruckState::MINING);
+        }
+    }
+}
+
+/// Advances the whole fleet by one tick
+/// \param now
+void TruckFleet::tick(SimTime now) {
+    assert(now == _nextTick);
+    _nextTick = now + 1;
+    if (_workerPool) {
+        _workerPool->run([this](int worker) { countDown(worker); });
+    } else {
+        countDown(0);
+    }
+
+    // Transitions touch the shared dispatchers, so they are committed in truck order, as in the
+    // tick loop; the partitions are contiguous and in order, so this is a simple concatenation
+    {
+        auto span = MineTraceSpan("expireTrucks");
+        for (std::size_t part = 0; part < _expired.size(); ++part) {
+            const auto* expired = _expired[part].data();
+            for (std::int32_t entry = 0; entry < _numExpired[part]; ++entry) {
+                expireTruck(expired[entry], now);
+            }
+        }
+    }
+
+    // Stations only read the trucks and write their own entries, so they can update in parallel
+    if (_workerPool) {
+        _workerPool->run([this, now](int worker) { updateStations(worker, now); });
+    } else {
+        updateStations(0, now);
+    }
+
+    if (_journal) {
+        journalStations(now);
+    }
+}
+
+/// Applies the MineStationState rules to one partition of the stations, after the trucks have
+/// moved
+/// \param partition
+/// \param now
+void TruckFleet::updateStations(int partition, SimTime now) {
+    auto span = MineTraceSpan("updateStations");
+    const auto first = _stationPartitions[partition];
+    const auto last = _stationPartitions[partition + 1];
+    for (auto station = first; station < last; ++station) {
+        const auto& stationQueue = _stationQueues[station];
+        switch (_stationState[station]) {
+        case StationState::IDLE:
+            if (!stationQueue.empty()) {
+                enterStationState(station, StationState::READY, now, partition);
+            }
+            break;
+        case StationState::READY:
+            if (!stationQueue.empty() && _truckState[stationQueue.front()] == TruckState::QUEUED) {
+                enterStationState(station, StationState::UNLOADING, now, partition);
+            }
+            break;
+        case StationState::UNLOADING:
+            if (--_stationRemaining[station] == 0) {
+                enterStationState(station, StationState::READY, now, partition);
+            }
+            break;
+        }
+    }
+}
+
+/// Withdraws trucks as if they had left at the end of the last tick run, and their sites had
+/// become idle on the next one
+/// \param count
+void TruckFleet::withdrawTrucks(int count) {
+    auto& dispatchOps = _counts[0].counts.dispatchOps;
+    for (auto truck = static_cast<std::int32_t>(_truckState.size()) - 1; truck >= 0 && count > 0;
+         --truck) {
+        if (_truckService[truck] != TruckService::ACTIVE) {
+            continue;
+        }
+        --count;
+        if (_truckState[truck] == TruckState::MINING) {
+            auto site = _truckSite[truck];
+            setMiningFlag(site, false, _nextTick);
+            _siteQueue.push(site);
+            ++dispatchOps[static_cast<std::size_t>(DispatchOp::SITE_ENQUEUE)];
+            park(truck, _nextTick - 1);
+        } else {
+            _truckService[truck] = TruckService::LEAVING;
+        }
+    }
+}
+
+/// Writes every array, queue in order and timer, with the dispatcher queue last
+/// \param fileName
+/// \throws std::runtime_error if the file cannot be written
+void TruckFleet::writeCheckpoint(const std::string& fileName) const {
+    CheckpointHeader header{};
+    header.magic = CHECKPOINT_MAGIC;
+    header.version = CHECKPOINT_VERSION;
+    header.ticksPerDay = TICKS_PER_DAY;
+    header.numTrucks = static_cast<std::uint32_t>(_truckState.size());
+    header.numStations = static_cast<std::uint32_t>(_stationState.size());
+    header.numSites = static_cast<std::uint32_t>(_siteMining.size());
+    header.nextTick = _nextTick;
+    header.seed = _seed;
+    auto writer = MineCheckpointWriter(fileName, header);
+
+    writer.write(_truckState);
+    writer.write(_truckRemaining);
+    writer.write(_truckSite);
+    writer.write(_truckStation);
+    writer.write(_truckPlaceInQueue);
+    writer.write(_truckEntered);
+    writer.write(_truckService);
+    writer.write(&_durations, 1);
+    for (const auto& truckTime : _truckTime) {
+        writer.write(truckTime);
+    }
+    writer.write(_stationVisits);
+
+    writer.write(_stationState);
+    writer.write(_stationRemaining);
+    writer.write(_stationEntered);
+    for (const auto& stationTime : _stationTime) {
+        writer.write(stationTime);
+    }
+    std::vector<std::int32_t> queueSizes;
+    std::vector<std::int32_t> queued;
+    for (const auto& stationQueue : _stationQueues) {
+        queueSizes.push_back(static_cast<std::int32_t>(stationQueue.size()));
+        for (std::size_t place = 0; place < stationQueue.size(); ++place) {
+            queued.push_back(stationQueue[place]);
+        }
+    }
+    writer.write(queueSizes);
+    writer.write(queued);
+
+    writer.write(_siteMining);
+    writer.write(_siteChanged);
+    writer.write(_siteIdleTime);
+    writer.write(_siteMiningTime);
+    writer.write(_siteTimers);
+    queued.clear();
+    for (std::size_t place = 0; place < _siteQueue.size(); ++place) {
+        queued.push_back(_siteQueue[place]);
+    }
+    writer.write(queued);
+    writer.close();
+}
+}  // namespace acme
\ No newline at end of file
@@ -0,0 +1,214 @@
+/// \file   TruckFleet.h
+/// \brief  Data-oriented (structure-of-arrays) model of the whole mining operation
+#pragma once
+#include "MineDefs.h"
+#include "MineIndexedHeap.h"
+#include "MineMetrics.h"
+#include "MineRingQueue.h"
+#include "MineStationState.h"
+#include "MineTimer.h"
+#include "MineTruckStates.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace acme {
+class MineJournal;
+class MinePacer;
+class MineStatsSink;
+class MineWorkerPool;
+
+/// \struct FleetDurations
+/// \brief  Durations of a TruckFleet's activities, in ticks; by default those of MineDefs.h and
+///         MineTimer.h
+struct FleetDurations {
+    std::int32_t transitTime{TRUCK_TRANSIT_TIME};
+    std::int32_t unloadingTime{TRUCK_UNLOADING_TIME};
+    std::int32_t miningMin{H3_MINING_MIN};
+    std::int32_t miningMax{H3_MINING_MAX};
+};
+
+/// \struct FleetSummary
+/// \brief  Whole-fleet totals of a simulation day, from which its throughput, queue wait and
+///         utilization follow
+struct FleetSummary {
+    std::int32_t numTrucks;       // In service at the end of the day
+    std::int32_t numStations;
+    std::int64_t deliveries;      // Station visits completed
+    std::int64_t queuedTicks;     // Of every truck
+    std::int64_t unloadingTicks;  // Of every station
+    std::int64_t stationTicks;    // Of every station, in any state
+    std::int64_t miningTicks;     // Of every site
+    std::int64_t siteTicks;       // Of every site, in either state
+
+    /// Returns the deliveries per hour of the day
+    double getDeliveriesPerHour() const;
+
+    /// Returns the minutes queued per delivery
+    double getMeanQueueWait() const;
+
+    /// Returns the fraction of their time the sites were mined
+    double getSiteUtilization() const;
+
+    /// Returns the fraction of their time the stations were unloading
+    double getStationUtilization() const;
+};
+
+/// \class  TruckFleet
+/// \brief  Keeps every truck, station and site in contiguous per-attribute arrays
+/// \note   Follows the same rules as MineTruck, MineStation and MineSite, in the same order, so
+///         the CSV statistics match those of the object engines. Time in state is accumulated
+///         from entry and exit ticks rather than counted on every tick.
+/// \note   With a MineWorkerPool, the countdowns and station updates are split across the
+///         workers, while the transitions that touch the dispatchers and station queues are
+///         committed on the calling thread in truck order, so the results do not depend on the
+///         number of workers.
+class TruckFleet {
+public:
+    /// Constructor; site timers draw from the seed's stream for their site id
+    TruckFleet(
+        int numTrucks,
+        int numStations,
+        int numSites,
+        std::uint64_t seed = 0,
+        const FleetDurations& durations = FleetDurations());
+
+    TruckFleet() = delete;
+    TruckFleet(const TruckFleet&) = delete;
+    TruckFleet& operator=(const TruckFleet&) = delete;
+
+    /// Adds IDLE stations, which the dispatcher can choose from the next tick on
+    void addStations(int count);
+
+    ///
+    int getIdleTime(int site) const;
+
+    ///
+    int getMiningTime(int site) const;
+
+    /// Returns the first tick still to run
+    SimTime getNextTick() const;
+
+    /// Returns the seed the site timers were drawn from
+    std::uint64_t getSeed() const;
+
+    /// Totals the day so far; call it after run, for the whole day
+    FleetSummary getSummary() const;
+
+    ///
+    int getTimeInState(int truck, TruckState truckState) const;
+
+    ///
+    int getTimeInState(int station, StationState stationState) const;
+
+    ///
+    void outputStatistics(MineStatsSink& stats) const;
+
+    /// Replaces the whole state of the day with a checkpoint, in place of startTrucksAtMines
+    /// \throws std::runtime_error if the file is not a checkpoint of a fleet of this size, or is
+    ///         corrupt
+    void readCheckpoint(const std::string& fileName);
+
+    /// Runs from the next tick up to, but not including, endTick; the day is finished when endTick
+    /// is its end
+    void run(MinePacer& pacer, SimTime endTick = TICKS_PER_DAY);
+
+    /// Records every transition and dispatch in a MineJournal, from startTrucksAtMines on;
+    /// nullptr records nothing
+    void setJournal(MineJournal* journal);
+
+    /// Sets the transit time of the trips that start from the next tick on
+    void setTransitTime(int ticks);
+
+    ///
+    void setWorkerPool(MineWorkerPool* workerPool);
+
+    ///
+    void startTrucksAtMines();
+
+    /// Advances the whole fleet by one tick; ticks are run in order, from 0
+    void tick(SimTime now);
+
+    /// Takes the highest-numbered trucks still in service out of it before the next tick; a
+    /// mining truck leaves its site at once, any other after it has next unloaded
+    void withdrawTrucks(int count);
+
+    /// Writes the whole state of the day, before the next tick, to a checkpoint
+    /// \throws std::runtime_error if the file cannot be written
+    void writeCheckpoint(const std::string& fileName) const;
+
+private:
+    void countDown(int partition);
+    void enterStationState(
+        std::int32_t station,
+        StationState stationState,
+        SimTime now,
+        int partition);
+    void enterTruckState(std::int32_t truck, TruckState truckState, SimTime now);
+    void expireTruck(std::int32_t truck, SimTime now);
+    void finish(SimTime lastTick);
+    void mergeMetrics();
+    void journalStations(SimTime now);
+    void park(std::int32_t truck, SimTime now);
+    void partition(int numPartitions);
+    void setMiningFlag(std::int32_t site, bool beingMined, SimTime now);
+    void updateStations(int partition, SimTime now);
+
+    /// Whether a truck is in service; a parked truck's time stops at the tick it left
+    enum class TruckService : std::uint8_t { ACTIVE, LEAVING, PARKED };
+
+    /// Remaining duration of a parked truck, which never counts down to 0 within a day
+    static constexpr std::int32_t PARKED_REMAINING = 1 << 30;
+
+    MineJournal* _journal{nullptr};
+    std::uint64_t _seed;
+    SimTime _nextTick{0};
+    FleetDurations _durations;
+
+    /// Counters of one partition, on cache lines of their own
+    struct alignas(64) PartitionCounts {
+        MineMetricCounts counts;
+    };
+
+    // Workers, and the contiguous truck and station ranges they own; the first partition also
+    // counts the transitions and dispatches committed on the calling thread
+    MineWorkerPool* _workerPool{nullptr};
+    std::vector<std::int32_t> _truckPartitions;
+    std::vector<std::int32_t> _stationPartitions;
+    std::vector<PartitionCounts> _counts;
+
+    // Trucks
+    std::vector<TruckState> _truckState;
+    std::vector<std::int32_t> _truckRemaining;
+    std::vector<std::int32_t> _truckSite;
+    std::vector<std::int32_t> _truckStation;
+    std::vector<std::int32_t> _truckPlaceInQueue;
+    std::vector<SimTime> _truckEntered;
+    std::vector<TruckService> _truckService;
+    std::array<std::vector<std::int32_t>, NUM_TRUCK_STATES> _truckTime;
+    std::vector<std::vector<std::int32_t>> _expired;
+    std::vector<std::int32_t> _numExpired;
+    std::vector<std::pair<std::int32_t, std::int32_t>> _stationVisits;
+
+    // Stations
+    std::vector<StationState> _stationState;
+    std::vector<std::int32_t> _stationRemaining;
+    std::vector<SimTime> _stationEntered;
+    std::array<std::vector<std::int32_t>, NUM_STATION_STATES> _stationTime;
+    std::vector<MineRingQueue<std::int32_t>> _stationQueues;
+
+    // Sites
+    std::vector<std::uint8_t> _siteMining;
+    std::vector<SimTime> _siteChanged;
+    std::vector<std::int32_t> _siteIdleTime;
+    std::vector<std::int32_t> _siteMiningTime;
+    std::vector<MineTimer> _siteTimers;
+
+    // Dispatchers
+    MineRingQueue<std::int32_t> _siteQueue;
+    MineIndexedHeap<> _stationHeap;  // Queue sizes, the same ordering as StationDispatcher
+};
+}  // namespace acme
\ No newline at end of file